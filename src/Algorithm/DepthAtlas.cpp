@@ -0,0 +1,63 @@
+#include <Algorithm/DepthAtlas.h>
+#include <Algorithm/vtkQuantizingFilter.h>
+
+DepthAtlas::DepthAtlas(unsigned int imageWidth, unsigned int imageHeight, float wInterval, float hInterval)
+    : imageWidth(imageWidth), imageHeight(imageHeight), wInterval(wInterval), hInterval(hInterval)
+{
+    image = vtkSmartPointer<vtkImageData>::New();
+}
+
+void DepthAtlas::Quantize(const vector<vtkSmartPointer<vtkPolyData>>& patches)
+{
+    numberOfTiles = patches.size();
+    auto tileSize = (size_t)imageWidth * imageHeight;
+
+    // One allocation for the whole batch, every patch owns one slice of it
+    vtkNew<vtkFloatArray> depths;
+    depths->SetName("Depth");
+    depths->SetNumberOfComponents(1);
+    depths->SetNumberOfTuples((vtkIdType)(tileSize * numberOfTiles));
+    auto buffer = depths->GetPointer(0);
+
+    vtkSMPTools::For(0, (vtkIdType)numberOfTiles, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                auto tile = buffer + tileSize * i;
+                std::fill(tile, tile + tileSize, vtkQuantizingFilter::EmptyDepth);
+
+                if (nullptr != patches[i])
+                {
+                    vtkQuantizingFilter::QuantizePoints(patches[i]->GetPoints(), tile,
+                        imageWidth, imageHeight, wInterval, hInterval);
+                }
+            }
+        });
+
+    image = vtkSmartPointer<vtkImageData>::New();
+    image->SetDimensions((int)imageWidth, (int)imageHeight, (int)numberOfTiles);
+    image->SetSpacing(wInterval, hInterval, 1.0);
+    image->SetOrigin(-(double)imageWidth * 0.5 * wInterval, -(double)imageHeight * 0.5 * hInterval, 0.0);
+    image->GetPointData()->SetScalars(depths);
+}
+
+float* DepthAtlas::GetTile(size_t index)
+{
+    if (numberOfTiles <= index) return nullptr;
+
+    auto depths = vtkFloatArray::SafeDownCast(image->GetPointData()->GetScalars());
+    return depths->GetPointer(0) + (size_t)imageWidth * imageHeight * index;
+}
+
+vtkSmartPointer<vtkPolyData> DepthAtlas::GetTilePolyData(size_t index)
+{
+    auto tile = GetTile(index);
+    if (nullptr == tile) return nullptr;
+
+    auto points = vtkQuantizingFilter::DepthsToPoints(tile, imageWidth, imageHeight, wInterval, hInterval);
+
+    auto polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(points);
+    vtkQuantizingFilter::SetGridDimensions(polyData, imageWidth, imageHeight);
+    return polyData;
+}
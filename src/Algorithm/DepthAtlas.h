@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Common.h>
+
+// Quantizes a batch of patches into one stack of depth images.
+// Slice i of the image holds the depth grid vtkQuantizingFilter would produce for patch i.
+class DepthAtlas
+{
+public:
+    DepthAtlas(unsigned int imageWidth = 256, unsigned int imageHeight = 480, float wInterval = 0.1f, float hInterval = 0.1f);
+
+    void Quantize(const vector<vtkSmartPointer<vtkPolyData>>& patches);
+
+    inline vtkImageData* GetImage() { return image; }
+    inline size_t GetNumberOfTiles() const { return numberOfTiles; }
+    inline unsigned int GetImageWidth() const { return imageWidth; }
+    inline unsigned int GetImageHeight() const { return imageHeight; }
+
+    float* GetTile(size_t index);
+    vtkSmartPointer<vtkPolyData> GetTilePolyData(size_t index);
+
+private:
+    unsigned int imageWidth;
+    unsigned int imageHeight;
+    float wInterval;
+    float hInterval;
+
+    size_t numberOfTiles = 0;
+    vtkSmartPointer<vtkImageData> image;
+};
@@ -0,0 +1,194 @@
+#include <Algorithm/HalfEdgeMesh.h>
+
+#include <atomic>
+
+namespace
+{
+    struct HalfEdgeKey
+    {
+        vtkIdType a;
+        vtkIdType b;
+        vtkIdType h;
+
+        inline bool operator<(const HalfEdgeKey& other) const
+        {
+            return a != other.a ? a < other.a : (b != other.b ? b < other.b : h < other.h);
+        }
+        inline bool SameEdge(const HalfEdgeKey& other) const { return a == other.a && b == other.b; }
+    };
+}
+
+bool HalfEdgeMesh::FromPolyData(vtkPolyData* mesh, HalfEdgeMesh& halfEdgeMesh)
+{
+    if (nullptr == mesh || nullptr == mesh->GetPoints())
+        return false;
+
+    auto polys = mesh->GetPolys();
+    auto numberOfCells = polys->GetNumberOfCells();
+    auto floatPoints = vtkFloatArray::FastDownCast(mesh->GetPoints()->GetData());
+    bool triangles = 8 == sizeof(vtkIdType) && polys->IsStorage64Bit()
+        && polys->GetNumberOfConnectivityIds() == numberOfCells * 3 && (0 == numberOfCells || 3 == polys->GetMaxCellSize());
+    if (nullptr != floatPoints && triangles)
+    {
+        halfEdgeMesh.points = floatPoints;
+        halfEdgeMesh.offsets = polys->GetOffsetsArray();
+        halfEdgeMesh.connectivity = polys->GetConnectivityArray();
+        halfEdgeMesh.xyz = floatPoints->GetPointer(0);
+        halfEdgeMesh.origins = (const vtkIdType*)halfEdgeMesh.connectivity->GetVoidPointer(0);
+        halfEdgeMesh.vertexHalfEdges.assign(mesh->GetNumberOfPoints(), -1);
+        return halfEdgeMesh.Build();
+    }
+
+    auto numberOfPoints = mesh->GetNumberOfPoints();
+    vector<float> xyz((size_t)numberOfPoints * 3);
+    auto points = mesh->GetPoints();
+    vtkSMPTools::For(0, numberOfPoints, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                double p[3];
+                points->GetPoint(i, p);
+                for (int axis = 0; axis < 3; axis++) xyz[i * 3 + axis] = (float)p[axis];
+            }
+        });
+
+    vector<vtkIdType> fan;
+    vtkIdType npts;
+    const vtkIdType* pts;
+    vtkNew<vtkIdList> ids;
+    for (vtkIdType c = 0; c < numberOfCells; c++)
+    {
+        polys->GetCellAtId(c, npts, pts, ids);
+        for (vtkIdType i = 2; i < npts; i++)
+        {
+            fan.push_back(pts[0]);
+            fan.push_back(pts[i - 1]);
+            fan.push_back(pts[i]);
+        }
+    }
+
+    return FromTriangles(xyz.data(), numberOfPoints, fan.data(), (vtkIdType)(fan.size() / 3), halfEdgeMesh);
+}
+
+bool HalfEdgeMesh::FromTriangles(const float* xyz, vtkIdType numberOfPoints,
+    const vtkIdType* triangles, vtkIdType numberOfTriangles, HalfEdgeMesh& halfEdgeMesh)
+{
+    auto points = vtkSmartPointer<vtkFloatArray>::New();
+    points->SetNumberOfComponents(3);
+    points->SetNumberOfTuples(numberOfPoints);
+    std::copy(xyz, xyz + numberOfPoints * 3, points->GetPointer(0));
+
+    auto offsets = vtkSmartPointer<vtkIdTypeArray>::New();
+    offsets->SetNumberOfTuples(numberOfTriangles + 1);
+    auto connectivity = vtkSmartPointer<vtkIdTypeArray>::New();
+    connectivity->SetNumberOfTuples(numberOfTriangles * 3);
+    auto offsetPointer = offsets->GetPointer(0);
+    auto connectivityPointer = connectivity->GetPointer(0);
+    offsetPointer[numberOfTriangles] = numberOfTriangles * 3;
+    vtkSMPTools::For(0, numberOfTriangles, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType t = begin; t < end; t++)
+            {
+                offsetPointer[t] = t * 3;
+                for (int c = 0; c < 3; c++) connectivityPointer[t * 3 + c] = triangles[t * 3 + c];
+            }
+        });
+
+    halfEdgeMesh.points = points;
+    halfEdgeMesh.offsets = offsets;
+    halfEdgeMesh.connectivity = connectivity;
+    halfEdgeMesh.xyz = points->GetPointer(0);
+    halfEdgeMesh.origins = connectivityPointer;
+    halfEdgeMesh.vertexHalfEdges.assign(numberOfPoints, -1);
+    return halfEdgeMesh.Build();
+}
+
+bool HalfEdgeMesh::Build()
+{
+    auto numberOfVertices = GetNumberOfVertices();
+    auto numberOfHalfEdges = connectivity->GetNumberOfValues();
+
+    std::atomic<bool> valid{ true };
+    vtkSMPTools::For(0, numberOfHalfEdges, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType h = begin; h < end; h++)
+            {
+                if (origins[h] < 0 || numberOfVertices <= origins[h]) valid = false;
+            }
+        });
+    if (false == valid)
+        return false;
+
+    // Half-edges of the same edge end up next to each other, only a pair running both ways becomes twins
+    vector<HalfEdgeKey> keys(numberOfHalfEdges);
+    vtkSMPTools::For(0, numberOfHalfEdges, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType h = begin; h < end; h++)
+            {
+                auto a = Origin(h);
+                auto b = Target(h);
+                keys[h] = { std::min(a, b), std::max(a, b), h };
+            }
+        });
+    vtkSMPTools::Sort(keys.begin(), keys.end());
+
+    twins.assign(numberOfHalfEdges, -1);
+    vtkSMPTools::For(0, numberOfHalfEdges, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType k = begin; k < end; k++)
+            {
+                if (0 < k && keys[k - 1].SameEdge(keys[k]))
+                    continue;
+                auto count = 1;
+                while (k + count < numberOfHalfEdges && keys[k + count].SameEdge(keys[k])) count++;
+                if (2 != count)
+                    continue;
+
+                auto h0 = keys[k].h;
+                auto h1 = keys[k + 1].h;
+                if (Origin(h0) == Target(h1))
+                {
+                    twins[h0] = h1;
+                    twins[h1] = h0;
+                }
+            }
+        });
+
+    // Boundary vertices start at their boundary half-edge, so a ring walk covers the whole fan
+    for (vtkIdType h = 0; h < numberOfHalfEdges; h++)
+    {
+        auto& vertexHalfEdge = vertexHalfEdges[Origin(h)];
+        if (-1 == vertexHalfEdge || (IsBoundary(h) && false == IsBoundary(vertexHalfEdge)))
+            vertexHalfEdge = h;
+    }
+
+    boundaryLoops.clear();
+    vector<unsigned char> visited(numberOfHalfEdges, 0);
+    for (vtkIdType h = 0; h < numberOfHalfEdges; h++)
+    {
+        if (false == IsBoundary(h) || visited[h] || vertexHalfEdges[Origin(h)] != h)
+            continue;
+
+        boundaryLoops.push_back(h);
+        for (auto current = h; false == visited[current] && IsBoundary(current); current = NextBoundary(current))
+        {
+            visited[current] = 1;
+        }
+    }
+
+    return true;
+}
+
+vtkSmartPointer<vtkPolyData> HalfEdgeMesh::ToPolyData() const
+{
+    vtkNew<vtkPoints> newPoints;
+    newPoints->SetData(points);
+
+    vtkNew<vtkCellArray> polys;
+    polys->SetData(offsets, connectivity);
+
+    auto output = vtkSmartPointer<vtkPolyData>::New();
+    output->SetPoints(newPoints);
+    output->SetPolys(polys);
+    return output;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Common.h>
+
+// Index based half-edge triangle mesh.
+// Half-edge h is corner h % 3 of triangle h / 3 and runs from that corner to the next one, so the origins of the
+// half-edges are exactly the triangle connectivity and next, prev and face need no storage. Only the twins and one
+// outgoing half-edge per vertex are kept, and the points and connectivity are VTK arrays shared with ToPolyData.
+// Edges used by one triangle, by more than two, or by two with the same direction have no twin and count as boundary.
+class HalfEdgeMesh
+{
+public:
+    // Iterates the outgoing half-edges of a vertex counterclockwise, starting at the boundary for boundary vertices.
+    // The last neighbour of a boundary vertex has no outgoing half-edge towards it, it is Origin(Prev(last)).
+    class Ring
+    {
+    public:
+        class Iterator
+        {
+        public:
+            Iterator(const HalfEdgeMesh* mesh, vtkIdType start, vtkIdType current)
+                : mesh(mesh), start(start), current(current) {}
+
+            inline vtkIdType operator*() const { return current; }
+            inline Iterator& operator++()
+            {
+                auto next = mesh->Twin(mesh->Prev(current));
+                current = next == start ? -1 : next;
+                return *this;
+            }
+            inline bool operator==(const Iterator& other) const { return current == other.current; }
+            inline bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+        private:
+            const HalfEdgeMesh* mesh;
+            vtkIdType start;
+            vtkIdType current;
+        };
+
+        Ring(const HalfEdgeMesh* mesh, vtkIdType start) : mesh(mesh), start(start) {}
+
+        inline Iterator begin() const { return Iterator(mesh, start, start); }
+        inline Iterator end() const { return Iterator(mesh, start, -1); }
+
+    private:
+        const HalfEdgeMesh* mesh;
+        vtkIdType start;
+    };
+
+    HalfEdgeMesh() {}
+
+    // Polygons are fan triangulated, float points and triangle only 64 bit cells are taken over without a copy.
+    static bool FromPolyData(vtkPolyData* mesh, HalfEdgeMesh& halfEdgeMesh);
+    static bool FromTriangles(const float* xyz, vtkIdType numberOfPoints,
+        const vtkIdType* triangles, vtkIdType numberOfTriangles, HalfEdgeMesh& halfEdgeMesh);
+
+    // Shares the point and connectivity arrays.
+    vtkSmartPointer<vtkPolyData> ToPolyData() const;
+
+    inline vtkIdType GetNumberOfVertices() const { return (vtkIdType)vertexHalfEdges.size(); }
+    inline vtkIdType GetNumberOfFaces() const { return (vtkIdType)twins.size() / 3; }
+    inline vtkIdType GetNumberOfHalfEdges() const { return (vtkIdType)twins.size(); }
+
+    inline vtkIdType Face(vtkIdType h) const { return h / 3; }
+    inline vtkIdType Next(vtkIdType h) const { return 2 == h % 3 ? h - 2 : h + 1; }
+    inline vtkIdType Prev(vtkIdType h) const { return 0 == h % 3 ? h + 2 : h - 1; }
+    inline vtkIdType Twin(vtkIdType h) const { return twins[h]; }
+    inline vtkIdType Origin(vtkIdType h) const { return origins[h]; }
+    inline vtkIdType Target(vtkIdType h) const { return origins[Next(h)]; }
+    inline bool IsBoundary(vtkIdType h) const { return -1 == twins[h]; }
+
+    // -1 for vertices no triangle uses
+    inline vtkIdType GetHalfEdge(vtkIdType v) const { return vertexHalfEdges[v]; }
+    inline bool IsBoundaryVertex(vtkIdType v) const { return -1 != vertexHalfEdges[v] && IsBoundary(vertexHalfEdges[v]); }
+    inline Ring GetRing(vtkIdType v) const { return Ring(this, vertexHalfEdges[v]); }
+
+    inline void GetPoint(vtkIdType v, float* p) const { p[0] = xyz[v * 3]; p[1] = xyz[v * 3 + 1]; p[2] = xyz[v * 3 + 2]; }
+
+    // The boundary half-edge leaving the target of a boundary half-edge, walks a boundary loop.
+    // Vertices where several boundary loops meet keep only one of their boundary half-edges.
+    inline vtkIdType NextBoundary(vtkIdType h) const { return vertexHalfEdges[Target(h)]; }
+    // One boundary half-edge per boundary loop
+    inline const vector<vtkIdType>& GetBoundaryLoops() const { return boundaryLoops; }
+
+private:
+    vtkSmartPointer<vtkFloatArray> points;
+    vtkSmartPointer<vtkDataArray> offsets;
+    vtkSmartPointer<vtkDataArray> connectivity;
+    const float* xyz = nullptr;
+    const vtkIdType* origins = nullptr;
+
+    vector<vtkIdType> twins;
+    vector<vtkIdType> vertexHalfEdges;
+    vector<vtkIdType> boundaryLoops;
+
+    bool Build();
+};
@@ -0,0 +1,431 @@
+#include <Algorithm/MeshStitcher.h>
+#include <Algorithm/HalfEdgeMesh.h>
+
+namespace
+{
+    struct StitchPatch
+    {
+        vtkPolyData* mesh = nullptr;
+        // Over the vertices of the kept triangles, built once the patch's own overlap is decided
+        vtkSmartPointer<vtkPolyData> keptPoints;
+        vtkSmartPointer<vtkStaticPointLocator> locator;
+        double bounds[6];
+        vtkIdType firstPoint = 0;
+        // Three point ids per triangle, local to the patch
+        vector<vtkIdType> triangles;
+        vector<unsigned char> removed;
+    };
+
+    void Triangulate(vtkPolyData* mesh, vector<vtkIdType>& triangles)
+    {
+        triangles.clear();
+        auto polys = mesh->GetPolys();
+        if (nullptr == polys)
+            return;
+
+        vtkIdType npts;
+        const vtkIdType* pts;
+        vtkNew<vtkIdList> ids;
+        for (vtkIdType c = 0; c < polys->GetNumberOfCells(); c++)
+        {
+            polys->GetCellAtId(c, npts, pts, ids);
+            for (vtkIdType i = 2; i < npts; i++)
+            {
+                triangles.push_back(pts[0]);
+                triangles.push_back(pts[i - 1]);
+                triangles.push_back(pts[i]);
+            }
+        }
+    }
+
+    inline bool BoundsOverlap(const double* a, const double* b, double margin)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (a[axis * 2 + 1] + margin < b[axis * 2] || b[axis * 2 + 1] + margin < a[axis * 2])
+                return false;
+        }
+        return true;
+    }
+
+    struct TriangleKey
+    {
+        vtkIdType ids[3];
+        vtkIdType triangle;
+
+        inline bool operator<(const TriangleKey& other) const
+        {
+            if (ids[0] != other.ids[0]) return ids[0] < other.ids[0];
+            if (ids[1] != other.ids[1]) return ids[1] < other.ids[1];
+            if (ids[2] != other.ids[2]) return ids[2] < other.ids[2];
+            return triangle < other.triangle;
+        }
+
+        inline bool SameTriangle(const TriangleKey& other) const
+        {
+            return ids[0] == other.ids[0] && ids[1] == other.ids[1] && ids[2] == other.ids[2];
+        }
+    };
+}
+
+MeshStitcher::MeshStitcher(double overlapDistance, double snapDistance)
+    : overlapDistance(overlapDistance), snapDistance(snapDistance)
+{
+}
+
+void MeshStitcher::AddPatch(vtkPolyData* mesh)
+{
+    if (nullptr == mesh || 0 == mesh->GetNumberOfPoints())
+        return;
+    patches.push_back(mesh);
+}
+
+vtkSmartPointer<vtkPolyData> MeshStitcher::Stitch()
+{
+    statistics = MeshStitchStatistics();
+    auto numberOfPatches = patches.size();
+
+    // Triangles and point locators, one patch per task
+    vector<StitchPatch> stitchPatches(numberOfPatches);
+    vtkIdType numberOfPoints = 0;
+    for (size_t p = 0; p < numberOfPatches; p++)
+    {
+        auto& patch = stitchPatches[p];
+        patch.mesh = patches[p];
+        patch.mesh->GetBounds(patch.bounds);
+        patch.firstPoint = numberOfPoints;
+        numberOfPoints += patch.mesh->GetNumberOfPoints();
+    }
+    vtkSMPTools::For(0, (vtkIdType)numberOfPatches, 1, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType p = begin; p < end; p++)
+            {
+                auto& patch = stitchPatches[p];
+                Triangulate(patch.mesh, patch.triangles);
+                patch.removed.assign(patch.triangles.size() / 3, 0);
+            }
+        });
+
+    // The earlier patch of a pair keeps the overlap
+    vector<vector<size_t>> keepers(numberOfPatches);
+    vector<unsigned char> isKeeper(numberOfPatches, 0);
+    for (size_t i = 0; i < numberOfPatches; i++)
+    {
+        for (size_t j = i + 1; j < numberOfPatches; j++)
+        {
+            if (BoundsOverlap(stitchPatches[i].bounds, stitchPatches[j].bounds, overlapDistance))
+            {
+                keepers[j].push_back(i);
+                isKeeper[i] = 1;
+                statistics.numberOfPairs++;
+            }
+        }
+    }
+
+    // Patches are decided in order and a keeper only offers the vertices of the triangles it kept. A region that an
+    // even earlier patch took over must not claim the triangles of a later patch, nothing would cover them then.
+    for (size_t p = 0; p < numberOfPatches; p++)
+    {
+        auto& patch = stitchPatches[p];
+        auto patchPoints = patch.mesh->GetPoints();
+        auto numberOfPatchTriangles = (vtkIdType)(patch.triangles.size() / 3);
+        if (false == keepers[p].empty())
+        {
+            vtkSMPTools::For(0, numberOfPatchTriangles, [&](vtkIdType begin, vtkIdType end)
+                {
+                    for (vtkIdType t = begin; t < end; t++)
+                    {
+                        for (auto k : keepers[p])
+                        {
+                            auto& keeper = stitchPatches[k];
+                            if (nullptr == keeper.locator)
+                                continue;
+
+                            bool inside = true;
+                            for (int c = 0; c < 3 && inside; c++)
+                            {
+                                double point[3];
+                                patchPoints->GetPoint(patch.triangles[t * 3 + c], point);
+                                // A point is its own zero sized bounds, far corners skip the locator
+                                double pointBounds[6] = { point[0], point[0], point[1], point[1], point[2], point[2] };
+                                double distance2;
+                                inside = BoundsOverlap(keeper.bounds, pointBounds, overlapDistance)
+                                    && 0 <= keeper.locator->FindClosestPointWithinRadius(overlapDistance, point, distance2);
+                            }
+                            if (inside)
+                            {
+                                patch.removed[t] = 1;
+                                break;
+                            }
+                        }
+                    }
+                });
+        }
+
+        if (0 == isKeeper[p])
+            continue;
+
+        vector<unsigned char> kept(patch.mesh->GetNumberOfPoints(), 0);
+        for (vtkIdType t = 0; t < numberOfPatchTriangles; t++)
+        {
+            if (0 == patch.removed[t])
+            {
+                for (int c = 0; c < 3; c++) kept[patch.triangles[t * 3 + c]] = 1;
+            }
+        }
+
+        vtkNew<vtkPoints> keptPoints;
+        keptPoints->SetDataTypeToFloat();
+        for (vtkIdType i = 0; i < (vtkIdType)kept.size(); i++)
+        {
+            if (kept[i]) keptPoints->InsertNextPoint(patchPoints->GetPoint(i));
+        }
+        if (0 == keptPoints->GetNumberOfPoints())
+            continue;
+
+        patch.keptPoints = vtkSmartPointer<vtkPolyData>::New();
+        patch.keptPoints->SetPoints(keptPoints);
+        patch.locator = vtkSmartPointer<vtkStaticPointLocator>::New();
+        patch.locator->SetDataSet(patch.keptPoints);
+        patch.locator->BuildLocator();
+    }
+
+    // Merged points and the kept triangles in global ids
+    vtkNew<vtkPoints> points;
+    points->SetDataTypeToFloat();
+    points->SetNumberOfPoints(numberOfPoints);
+    auto xyz = vtkFloatArray::FastDownCast(points->GetData())->GetPointer(0);
+    vector<int> pointPatch(numberOfPoints);
+    vector<vtkIdType> firstTriangle(numberOfPatches + 1, 0);
+
+    // Normals are carried over when every patch has them
+    bool hasNormals = 0 < numberOfPatches;
+    for (auto& patch : stitchPatches)
+    {
+        auto patchNormals = patch.mesh->GetPointData()->GetNormals();
+        hasNormals = hasNormals && nullptr != patchNormals && 3 == patchNormals->GetNumberOfComponents();
+    }
+    vector<float> normals(hasNormals ? (size_t)numberOfPoints * 3 : 0);
+    for (size_t p = 0; p < numberOfPatches; p++)
+    {
+        auto& removed = stitchPatches[p].removed;
+        auto kept = (vtkIdType)std::count(removed.begin(), removed.end(), (unsigned char)0);
+        statistics.removedTriangles += removed.size() - kept;
+        firstTriangle[p + 1] = firstTriangle[p] + kept;
+    }
+
+    auto numberOfTriangles = firstTriangle[numberOfPatches];
+    vector<vtkIdType> triangles(numberOfTriangles * 3);
+    vector<int> trianglePatch(numberOfTriangles);
+    vtkSMPTools::For(0, (vtkIdType)numberOfPatches, 1, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType p = begin; p < end; p++)
+            {
+                auto& patch = stitchPatches[p];
+                auto patchPoints = patch.mesh->GetPoints();
+                auto patchNormals = patch.mesh->GetPointData()->GetNormals();
+                for (vtkIdType i = 0; i < patch.mesh->GetNumberOfPoints(); i++)
+                {
+                    double point[3];
+                    patchPoints->GetPoint(i, point);
+                    auto id = patch.firstPoint + i;
+                    for (int axis = 0; axis < 3; axis++) xyz[id * 3 + axis] = (float)point[axis];
+                    pointPatch[id] = (int)p;
+
+                    if (hasNormals)
+                    {
+                        double normal[3];
+                        patchNormals->GetTuple(i, normal);
+                        for (int axis = 0; axis < 3; axis++) normals[id * 3 + axis] = (float)normal[axis];
+                    }
+                }
+
+                auto triangle = firstTriangle[p];
+                for (size_t t = 0; t < patch.removed.size(); t++)
+                {
+                    if (patch.removed[t])
+                        continue;
+                    for (int c = 0; c < 3; c++)
+                    {
+                        triangles[triangle * 3 + c] = patch.firstPoint + patch.triangles[t * 3 + c];
+                    }
+                    trianglePatch[triangle++] = (int)p;
+                }
+            }
+        });
+
+    // Boundary vertices are the seams to close
+    HalfEdgeMesh halfEdgeMesh;
+    HalfEdgeMesh::FromTriangles(xyz, numberOfPoints, triangles.data(), numberOfTriangles, halfEdgeMesh);
+
+    vector<unsigned char> used(numberOfPoints, 0);
+    for (auto id : triangles) used[id] = 1;
+
+    // Boundary vertices move onto the closest used vertex of an earlier patch, so snaps never form a cycle
+    vtkNew<vtkPolyData> cloud;
+    cloud->SetPoints(points);
+    vtkNew<vtkStaticPointLocator> locator;
+    locator->SetDataSet(cloud);
+    locator->BuildLocator();
+
+    vector<vtkIdType> snap(numberOfPoints);
+    vtkSMPThreadLocalObject<vtkIdList> neighbors;
+    vtkSMPTools::For(0, numberOfPoints, [&](vtkIdType begin, vtkIdType end)
+        {
+            auto result = neighbors.Local();
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                snap[i] = i;
+                if (false == halfEdgeMesh.IsBoundaryVertex(i) || 0 == pointPatch[i])
+                    continue;
+
+                double p[3] = { xyz[i * 3 + 0], xyz[i * 3 + 1], xyz[i * 3 + 2] };
+                locator->FindPointsWithinRadius(snapDistance, p, result);
+
+                double closest2 = numeric_limits<double>::max();
+                for (vtkIdType n = 0; n < result->GetNumberOfIds(); n++)
+                {
+                    auto candidate = result->GetId(n);
+                    if (0 == used[candidate] || pointPatch[i] <= pointPatch[candidate])
+                        continue;
+
+                    double d2 = 0.0;
+                    for (int axis = 0; axis < 3; axis++)
+                    {
+                        double d = xyz[candidate * 3 + axis] - p[axis];
+                        d2 += d * d;
+                    }
+                    if (d2 < closest2)
+                    {
+                        closest2 = d2;
+                        snap[i] = candidate;
+                    }
+                }
+            }
+        });
+
+    // Follow the snaps to their end, every step goes to an earlier patch
+    vector<vtkIdType> target(numberOfPoints);
+    vtkSMPTools::For(0, numberOfPoints, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                auto t = i;
+                while (snap[t] != t) t = snap[t];
+                target[i] = t;
+            }
+        });
+    for (vtkIdType i = 0; i < numberOfPoints; i++)
+    {
+        if (target[i] != i && used[i]) statistics.snappedPoints++;
+    }
+
+    // Collapsed triangles go, and of the triangles with the same corners only the first one stays
+    vector<TriangleKey> keys(numberOfTriangles);
+    vector<unsigned char> keep(numberOfTriangles, 1);
+    vtkSMPTools::For(0, numberOfTriangles, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType t = begin; t < end; t++)
+            {
+                auto& key = keys[t];
+                for (int c = 0; c < 3; c++)
+                {
+                    triangles[t * 3 + c] = target[triangles[t * 3 + c]];
+                    key.ids[c] = triangles[t * 3 + c];
+                }
+                std::sort(key.ids, key.ids + 3);
+                key.triangle = t;
+                if (key.ids[0] == key.ids[1] || key.ids[1] == key.ids[2])
+                    keep[t] = 0;
+            }
+        });
+    statistics.degenerateTriangles = (size_t)std::count(keep.begin(), keep.end(), (unsigned char)0);
+
+    vtkSMPTools::Sort(keys.begin(), keys.end());
+    for (size_t k = 1; k < keys.size(); k++)
+    {
+        if (keys[k].SameTriangle(keys[k - 1]) && keep[keys[k].triangle])
+        {
+            keep[keys[k].triangle] = 0;
+            statistics.duplicateTriangles++;
+        }
+    }
+
+    // Compact points and triangles, ids keep their order
+    vector<vtkIdType> pointMap(numberOfPoints + 1, 0);
+    vector<vtkIdType> triangleMap(numberOfTriangles + 1, 0);
+    for (vtkIdType t = 0; t < numberOfTriangles; t++)
+    {
+        triangleMap[t + 1] = triangleMap[t] + keep[t];
+        if (keep[t])
+        {
+            for (int c = 0; c < 3; c++) pointMap[triangles[t * 3 + c] + 1] = 1;
+        }
+    }
+    for (vtkIdType i = 0; i < numberOfPoints; i++)
+    {
+        pointMap[i + 1] += pointMap[i];
+    }
+
+    auto numberOfOutputPoints = pointMap[numberOfPoints];
+    auto numberOfOutputTriangles = triangleMap[numberOfTriangles];
+
+    vtkNew<vtkPoints> outputPoints;
+    outputPoints->SetDataTypeToFloat();
+    outputPoints->SetNumberOfPoints(numberOfOutputPoints);
+    auto outputXYZ = vtkFloatArray::FastDownCast(outputPoints->GetData())->GetPointer(0);
+    vtkNew<vtkFloatArray> outputNormals;
+    outputNormals->SetName("Normals");
+    outputNormals->SetNumberOfComponents(3);
+    outputNormals->SetNumberOfTuples(hasNormals ? numberOfOutputPoints : 0);
+    auto outputNormalPointer = outputNormals->GetPointer(0);
+    vtkSMPTools::For(0, numberOfPoints, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                if (pointMap[i] == pointMap[i + 1])
+                    continue;
+                for (int axis = 0; axis < 3; axis++) outputXYZ[pointMap[i] * 3 + axis] = xyz[i * 3 + axis];
+                if (hasNormals)
+                {
+                    for (int axis = 0; axis < 3; axis++) outputNormalPointer[pointMap[i] * 3 + axis] = normals[i * 3 + axis];
+                }
+            }
+        });
+
+    vtkNew<vtkIdTypeArray> offsets;
+    offsets->SetNumberOfTuples(numberOfOutputTriangles + 1);
+    auto offsetPointer = offsets->GetPointer(0);
+    offsetPointer[numberOfOutputTriangles] = numberOfOutputTriangles * 3;
+    vtkNew<vtkIdTypeArray> connectivity;
+    connectivity->SetNumberOfTuples(numberOfOutputTriangles * 3);
+    auto connectivityPointer = connectivity->GetPointer(0);
+    vtkNew<vtkIntArray> patchIds;
+    patchIds->SetName("PatchIds");
+    patchIds->SetNumberOfTuples(numberOfOutputTriangles);
+    auto patchIdPointer = patchIds->GetPointer(0);
+
+    vtkSMPTools::For(0, numberOfTriangles, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType t = begin; t < end; t++)
+            {
+                if (0 == keep[t])
+                    continue;
+                auto o = triangleMap[t];
+                offsetPointer[o] = o * 3;
+                for (int c = 0; c < 3; c++) connectivityPointer[o * 3 + c] = pointMap[triangles[t * 3 + c]];
+                patchIdPointer[o] = trianglePatch[t];
+            }
+        });
+
+    vtkNew<vtkCellArray> polys;
+    polys->SetData(offsets, connectivity);
+
+    auto output = vtkSmartPointer<vtkPolyData>::New();
+    output->SetPoints(outputPoints);
+    output->SetPolys(polys);
+    output->GetCellData()->AddArray(patchIds);
+    if (hasNormals)
+        output->GetPointData()->SetNormals(outputNormals);
+    return output;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Common.h>
+
+struct MeshStitchStatistics
+{
+    size_t numberOfPairs = 0;
+    size_t removedTriangles = 0;
+    size_t snappedPoints = 0;
+    size_t degenerateTriangles = 0;
+    size_t duplicateTriangles = 0;
+};
+
+// Merges independently meshed patches into one mesh.
+// Patches are taken in order, and a triangle is dropped when all of its corners lie within overlapDistance of a
+// vertex of the triangles an earlier overlapping patch kept, so overlapDistance should be about the vertex spacing.
+// The triangles of one patch are tested in parallel. The boundary vertices left over are snapped to the closest vertex of an earlier patch
+// within snapDistance, which closes the seams, and the triangles that collapse or repeat after snapping are removed.
+// Polygons are fan triangulated, the output has a PatchIds cell array, and Normals when every patch has them.
+class MeshStitcher
+{
+public:
+    MeshStitcher(double overlapDistance = 0.1, double snapDistance = 0.05);
+
+    void AddPatch(vtkPolyData* mesh);
+    inline size_t GetNumberOfPatches() const { return patches.size(); }
+
+    vtkSmartPointer<vtkPolyData> Stitch();
+
+    inline const MeshStitchStatistics& GetStatistics() const { return statistics; }
+
+private:
+    double overlapDistance;
+    double snapDistance;
+    vector<vtkSmartPointer<vtkPolyData>> patches;
+    MeshStitchStatistics statistics;
+};
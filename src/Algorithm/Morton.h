@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+// 63-bit Morton codes over 21-bit x, y, z, x in the lowest bit of every triple.
+
+// Spreads the low 21 bits of v so that two zero bits follow every bit
+inline uint64_t MortonPart1By2(uint64_t v)
+{
+    v &= 0x1fffff;
+    v = (v | (v << 32)) & 0x1f00000000ffffull;
+    v = (v | (v << 16)) & 0x1f0000ff0000ffull;
+    v = (v | (v << 8)) & 0x100f00f00f00f00full;
+    v = (v | (v << 4)) & 0x10c30c30c30c30c3ull;
+    v = (v | (v << 2)) & 0x1249249249249249ull;
+    return v;
+}
+
+inline uint64_t MortonCompact1By2(uint64_t v)
+{
+    v &= 0x1249249249249249ull;
+    v = (v | (v >> 2)) & 0x10c30c30c30c30c3ull;
+    v = (v | (v >> 4)) & 0x100f00f00f00f00full;
+    v = (v | (v >> 8)) & 0x1f0000ff0000ffull;
+    v = (v | (v >> 16)) & 0x1f00000000ffffull;
+    v = (v | (v >> 32)) & 0x1fffff;
+    return v;
+}
+
+inline uint64_t EncodeMorton(uint32_t x, uint32_t y, uint32_t z)
+{
+    return MortonPart1By2(x) | (MortonPart1By2(y) << 1) | (MortonPart1By2(z) << 2);
+}
+
+inline void DecodeMorton(uint64_t code, uint32_t& x, uint32_t& y, uint32_t& z)
+{
+    x = (uint32_t)MortonCompact1By2(code);
+    y = (uint32_t)MortonCompact1By2(code >> 1);
+    z = (uint32_t)MortonCompact1By2(code >> 2);
+}
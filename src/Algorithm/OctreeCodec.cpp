@@ -0,0 +1,460 @@
+#include <Algorithm/OctreeCodec.h>
+#include <Algorithm/Morton.h>
+
+#include <atomic>
+#include <cstring>
+
+namespace
+{
+    struct OctreeStreamHeader
+    {
+        char magic[4] = { 'S', 'V', 'O', 'O' };
+        uint32_t version = 1;
+        uint32_t depth = 0;
+        uint32_t splitLevel = 0;
+        uint64_t numberOfPoints = 0;
+        uint64_t numberOfVoxels = 0;
+        uint64_t numberOfSubtrees = 0;
+        uint64_t topSize = 0;
+        double boundsMin[3] = { 0.0, 0.0, 0.0 };
+        double cellSize = 1.0;
+    };
+
+    // Binary adaptive range coder with 11-bit probabilities, as used by LZMA
+    const int ProbabilityBits = 11;
+    const int AdaptationShift = 5;
+    const uint32_t TopValue = 1u << 24;
+
+    class RangeEncoder
+    {
+    public:
+        RangeEncoder(vector<unsigned char>& output) : output(output) {}
+
+        void EncodeBit(uint16_t& probability, unsigned bit)
+        {
+            uint32_t bound = (range >> ProbabilityBits) * probability;
+            if (0 == bit)
+            {
+                range = bound;
+                probability += ((1 << ProbabilityBits) - probability) >> AdaptationShift;
+            }
+            else
+            {
+                low += bound;
+                range -= bound;
+                probability -= probability >> AdaptationShift;
+            }
+
+            while (range < TopValue)
+            {
+                range <<= 8;
+                ShiftLow();
+            }
+        }
+
+        void Flush()
+        {
+            for (int i = 0; i < 5; i++) ShiftLow();
+        }
+
+    private:
+        vector<unsigned char>& output;
+        uint64_t low = 0;
+        uint32_t range = 0xFFFFFFFF;
+        unsigned char cache = 0;
+        uint64_t cacheSize = 1;
+
+        void ShiftLow()
+        {
+            if ((uint32_t)low < 0xFF000000u || 0 != (low >> 32))
+            {
+                auto carry = (unsigned char)(low >> 32);
+                auto temp = cache;
+                do
+                {
+                    output.push_back((unsigned char)(temp + carry));
+                    temp = 0xFF;
+                } while (0 != --cacheSize);
+                cache = (unsigned char)(low >> 24);
+            }
+            cacheSize++;
+            low = (low & 0x00FFFFFFu) << 8;
+        }
+    };
+
+    class RangeDecoder
+    {
+    public:
+        RangeDecoder(const unsigned char* begin, const unsigned char* end) : p(begin), end(end)
+        {
+            for (int i = 0; i < 5; i++) code = (code << 8) | Next();
+        }
+
+        unsigned DecodeBit(uint16_t& probability)
+        {
+            uint32_t bound = (range >> ProbabilityBits) * probability;
+            unsigned bit;
+            if (code < bound)
+            {
+                range = bound;
+                probability += ((1 << ProbabilityBits) - probability) >> AdaptationShift;
+                bit = 0;
+            }
+            else
+            {
+                code -= bound;
+                range -= bound;
+                probability -= probability >> AdaptationShift;
+                bit = 1;
+            }
+
+            while (range < TopValue)
+            {
+                range <<= 8;
+                code = (code << 8) | Next();
+            }
+            return bit;
+        }
+
+    private:
+        const unsigned char* p;
+        const unsigned char* end;
+        uint32_t range = 0xFFFFFFFF;
+        uint32_t code = 0;
+
+        inline unsigned char Next() { return p < end ? *p++ : 0; }
+    };
+
+    // One bit-tree over the 8 occupancy bits per count of occupied face neighbours
+    struct OccupancyModel
+    {
+        uint16_t probabilities[7][256];
+
+        OccupancyModel()
+        {
+            for (auto& context : probabilities)
+                std::fill(std::begin(context), std::end(context), (uint16_t)(1 << (ProbabilityBits - 1)));
+        }
+
+        void Encode(RangeEncoder& encoder, int context, unsigned occupancy)
+        {
+            unsigned node = 1;
+            for (int bit = 7; 0 <= bit; bit--)
+            {
+                auto b = (occupancy >> bit) & 1;
+                encoder.EncodeBit(probabilities[context][node], b);
+                node = (node << 1) | b;
+            }
+        }
+
+        unsigned Decode(RangeDecoder& decoder, int context)
+        {
+            unsigned node = 1;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                node = (node << 1) | decoder.DecodeBit(probabilities[context][node]);
+            }
+            return node - 256;
+        }
+    };
+
+    // Number of the 6 face neighbours present among the sorted node keys of the same level
+    int CountFaceNeighbors(const vector<uint64_t>& levelKeys, uint64_t key, int level)
+    {
+        uint32_t x, y, z;
+        DecodeMorton(key, x, y, z);
+        uint32_t limit = 1u << level;
+
+        int count = 0;
+        auto test = [&](uint32_t nx, uint32_t ny, uint32_t nz)
+        {
+            if (std::binary_search(levelKeys.begin(), levelKeys.end(), EncodeMorton(nx, ny, nz))) count++;
+        };
+
+        if (0 < x) test(x - 1, y, z);
+        if (x + 1 < limit) test(x + 1, y, z);
+        if (0 < y) test(x, y - 1, z);
+        if (y + 1 < limit) test(x, y + 1, z);
+        if (0 < z) test(x, y, z - 1);
+        if (z + 1 < limit) test(x, y, z + 1);
+        return count;
+    }
+
+    struct EncoderNode
+    {
+        uint64_t key;
+        size_t begin;
+        size_t end;
+    };
+
+    // Codes every node from fromLevel down to toLevel - 1 in breadth-first Morton order.
+    // Children of a node are contiguous in the sorted codes, so they come out sorted as well.
+    vector<EncoderNode> EncodeLevels(const vector<uint64_t>& codes, vector<EncoderNode> nodes,
+        int depth, int fromLevel, int toLevel, RangeEncoder& encoder, OccupancyModel& model)
+    {
+        vector<uint64_t> keys;
+        vector<EncoderNode> children;
+        for (int level = fromLevel; level < toLevel; level++)
+        {
+            keys.resize(nodes.size());
+            for (size_t i = 0; i < nodes.size(); i++) keys[i] = nodes[i].key;
+
+            children.clear();
+            int shift = 3 * (depth - level - 1);
+            for (auto& node : nodes)
+            {
+                unsigned occupancy = 0;
+                auto i = node.begin;
+                while (i < node.end)
+                {
+                    auto child = (unsigned)(codes[i] >> shift) & 7;
+                    auto j = i;
+                    while (j < node.end && child == ((unsigned)(codes[j] >> shift) & 7)) j++;
+
+                    occupancy |= 1u << child;
+                    children.push_back({ (node.key << 3) | child, i, j });
+                    i = j;
+                }
+
+                model.Encode(encoder, CountFaceNeighbors(keys, node.key, level), occupancy);
+            }
+            nodes.swap(children);
+        }
+        return nodes;
+    }
+
+    // Every occupied node has at least one child, so the levels of a valid stream only grow toward the voxel count
+    // of the header. budget holds the voxels not claimed by any level yet, shared by the subtrees decoded at once,
+    // and a level that shrinks or grows past it fails the decode before a corrupt stream can allocate without bound.
+    bool DecodeLevels(vector<uint64_t>& keys, int fromLevel, int toLevel,
+        RangeDecoder& decoder, OccupancyModel& model, std::atomic<int64_t>& budget)
+    {
+        vector<uint64_t> children;
+        for (int level = fromLevel; level < toLevel; level++)
+        {
+            children.clear();
+            for (auto key : keys)
+            {
+                auto occupancy = model.Decode(decoder, CountFaceNeighbors(keys, key, level));
+                if (0 == occupancy)
+                    return false;
+                for (unsigned child = 0; child < 8; child++)
+                {
+                    if (occupancy & (1u << child)) children.push_back((key << 3) | child);
+                }
+            }
+
+            auto growth = (int64_t)(children.size() - keys.size());
+            if (budget.fetch_sub(growth) < growth)
+                return false;
+            keys.swap(children);
+        }
+        return true;
+    }
+}
+
+bool OctreeCodec::Encode(vtkPolyData* data, vector<unsigned char>& stream,
+    int depth, int splitLevel, OctreeCodecStatistics* statistics)
+{
+    if (nullptr == data || nullptr == data->GetPoints() || depth < 1 || 21 < depth)
+        return false;
+
+    auto points = data->GetPoints();
+    auto nop = points->GetNumberOfPoints();
+
+    OctreeStreamHeader header;
+    header.depth = (uint32_t)depth;
+    header.splitLevel = (uint32_t)std::clamp(splitLevel, 0, depth - 1);
+    header.numberOfPoints = (uint64_t)nop;
+
+    double bounds[6];
+    points->GetBounds(bounds);
+    auto maximumExtent = std::max({ bounds[1] - bounds[0], bounds[3] - bounds[2], bounds[5] - bounds[4] });
+    auto resolution = (double)(1u << depth);
+    header.cellSize = 0.0 < maximumExtent ? maximumExtent / resolution : 1.0;
+    for (int axis = 0; axis < 3; axis++) header.boundsMin[axis] = bounds[axis * 2];
+
+    vector<uint64_t> codes(nop);
+    vtkSMPTools::For(0, nop, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                double p[3];
+                points->GetPoint(i, p);
+
+                uint32_t q[3];
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    auto value = std::floor((p[axis] - header.boundsMin[axis]) / header.cellSize);
+                    q[axis] = (uint32_t)std::clamp(value, 0.0, resolution - 1.0);
+                }
+                codes[i] = EncodeMorton(q[0], q[1], q[2]);
+            }
+        });
+
+    vtkSMPTools::Sort(codes.begin(), codes.end());
+    codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+    header.numberOfVoxels = codes.size();
+
+    vector<unsigned char> top;
+    vector<EncoderNode> roots;
+    {
+        RangeEncoder encoder(top);
+        OccupancyModel model;
+        vector<EncoderNode> root;
+        if (false == codes.empty()) root.push_back({ 0, 0, codes.size() });
+        roots = EncodeLevels(codes, root, depth, 0, (int)header.splitLevel, encoder, model);
+        encoder.Flush();
+    }
+    header.numberOfSubtrees = roots.size();
+    header.topSize = top.size();
+
+    vector<vector<unsigned char>> subtrees(roots.size());
+    vtkSMPTools::For(0, (vtkIdType)roots.size(), [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType s = begin; s < end; s++)
+            {
+                RangeEncoder encoder(subtrees[s]);
+                OccupancyModel model;
+                EncodeLevels(codes, { roots[s] }, depth, (int)header.splitLevel, depth, encoder, model);
+                encoder.Flush();
+            }
+        });
+
+    auto tableSize = sizeof(uint32_t) * subtrees.size();
+    size_t totalSize = sizeof(OctreeStreamHeader) + top.size() + tableSize;
+    for (auto& subtree : subtrees) totalSize += subtree.size();
+
+    stream.resize(totalSize);
+    auto p = stream.data();
+    memcpy(p, &header, sizeof(OctreeStreamHeader));
+    p += sizeof(OctreeStreamHeader);
+    memcpy(p, top.data(), top.size());
+    p += top.size();
+    for (auto& subtree : subtrees)
+    {
+        auto size = (uint32_t)subtree.size();
+        memcpy(p, &size, sizeof(uint32_t));
+        p += sizeof(uint32_t);
+    }
+    for (auto& subtree : subtrees)
+    {
+        memcpy(p, subtree.data(), subtree.size());
+        p += subtree.size();
+    }
+
+    if (nullptr != statistics)
+    {
+        statistics->numberOfPoints = (size_t)nop;
+        statistics->numberOfVoxels = codes.size();
+        statistics->numberOfSubtrees = subtrees.size();
+        statistics->numberOfBytes = stream.size();
+        statistics->bitsPerPoint = 0 < nop ? 8.0 * (double)stream.size() / (double)nop : 0.0;
+    }
+
+    return true;
+}
+
+vtkSmartPointer<vtkPolyData> OctreeCodec::Decode(const unsigned char* stream, size_t size,
+    OctreeCodecStatistics* statistics)
+{
+    OctreeStreamHeader header;
+    if (size < sizeof(OctreeStreamHeader))
+        return nullptr;
+
+    memcpy(&header, stream, sizeof(OctreeStreamHeader));
+    if (0 != memcmp(header.magic, "SVOO", 4) || 1 != header.version ||
+        header.depth < 1 || 21 < header.depth || header.depth <= header.splitLevel)
+        return nullptr;
+
+    auto end = stream + size;
+    auto p = stream + sizeof(OctreeStreamHeader);
+    if ((size_t)(end - p) < header.topSize + sizeof(uint32_t) * header.numberOfSubtrees)
+        return nullptr;
+
+    // The root is the first voxel of the budget
+    if ((uint64_t)numeric_limits<int64_t>::max() < header.numberOfVoxels)
+        return nullptr;
+    std::atomic<int64_t> budget((int64_t)header.numberOfVoxels - 1);
+
+    vector<uint64_t> roots;
+    if (0 < header.numberOfVoxels)
+    {
+        RangeDecoder decoder(p, p + header.topSize);
+        OccupancyModel model;
+        roots.push_back(0);
+        if (false == DecodeLevels(roots, 0, (int)header.splitLevel, decoder, model, budget))
+            return nullptr;
+    }
+    p += header.topSize;
+    if (roots.size() != header.numberOfSubtrees)
+        return nullptr;
+
+    // Sizes are checked against what is left of the stream before they are added, so no pointer goes past the end
+    vector<const unsigned char*> subtreeBegins(roots.size() + 1);
+    subtreeBegins[0] = p + sizeof(uint32_t) * roots.size();
+    for (size_t s = 0; s < roots.size(); s++)
+    {
+        uint32_t subtreeSize;
+        memcpy(&subtreeSize, p + sizeof(uint32_t) * s, sizeof(uint32_t));
+        if ((size_t)(end - subtreeBegins[s]) < subtreeSize)
+            return nullptr;
+        subtreeBegins[s + 1] = subtreeBegins[s] + subtreeSize;
+    }
+
+    vector<vector<uint64_t>> codes(roots.size());
+    std::atomic<bool> valid(true);
+    vtkSMPTools::For(0, (vtkIdType)roots.size(), [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType s = begin; s < end && valid; s++)
+            {
+                RangeDecoder decoder(subtreeBegins[s], subtreeBegins[s + 1]);
+                OccupancyModel model;
+                codes[s].push_back(roots[s]);
+                if (false == DecodeLevels(codes[s], (int)header.splitLevel, (int)header.depth, decoder, model, budget))
+                    valid = false;
+            }
+        });
+    if (false == valid)
+        return nullptr;
+
+    vector<size_t> firstVoxel(roots.size() + 1, 0);
+    for (size_t s = 0; s < roots.size(); s++) firstVoxel[s + 1] = firstVoxel[s] + codes[s].size();
+    if (firstVoxel[roots.size()] != header.numberOfVoxels)
+        return nullptr;
+
+    vtkNew<vtkPoints> points;
+    points->SetDataTypeToFloat();
+    points->SetNumberOfPoints((vtkIdType)header.numberOfVoxels);
+    auto xyz = vtkFloatArray::FastDownCast(points->GetData())->GetPointer(0);
+
+    vtkSMPTools::For(0, (vtkIdType)roots.size(), [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType s = begin; s < end; s++)
+            {
+                auto out = xyz + firstVoxel[s] * 3;
+                for (auto code : codes[s])
+                {
+                    uint32_t q[3];
+                    DecodeMorton(code, q[0], q[1], q[2]);
+                    for (int axis = 0; axis < 3; axis++)
+                    {
+                        *out++ = (float)(header.boundsMin[axis] + ((double)q[axis] + 0.5) * header.cellSize);
+                    }
+                }
+            }
+        });
+
+    if (nullptr != statistics)
+    {
+        statistics->numberOfPoints = (size_t)header.numberOfPoints;
+        statistics->numberOfVoxels = (size_t)header.numberOfVoxels;
+        statistics->numberOfSubtrees = roots.size();
+        statistics->numberOfBytes = size;
+        statistics->bitsPerPoint = 0 < header.numberOfPoints ? 8.0 * (double)size / (double)header.numberOfPoints : 0.0;
+    }
+
+    auto polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(points);
+    return polyData;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Common.h>
+
+struct OctreeCodecStatistics
+{
+    size_t numberOfPoints = 0;
+    size_t numberOfVoxels = 0;
+    size_t numberOfSubtrees = 0;
+    size_t numberOfBytes = 0;
+    double bitsPerPoint = 0.0;
+};
+
+// Octree geometry codec in the style of MPEG G-PCC.
+// Points are voxelized into a 2^depth cube, and every occupied octree node is coded as one child-occupancy byte
+// with a binary range coder whose contexts depend on how many face neighbours of the node are occupied.
+// The levels above splitLevel are coded as one stream, every node at splitLevel then roots an independent
+// subtree stream, so subtrees are encoded and decoded in parallel. Decoding yields one point per occupied voxel
+// at the voxel center.
+class OctreeCodec
+{
+public:
+    static bool Encode(vtkPolyData* data, vector<unsigned char>& stream,
+        int depth = 12, int splitLevel = 3, OctreeCodecStatistics* statistics = nullptr);
+
+    static vtkSmartPointer<vtkPolyData> Decode(const unsigned char* stream, size_t size,
+        OctreeCodecStatistics* statistics = nullptr);
+};
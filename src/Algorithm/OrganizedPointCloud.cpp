@@ -0,0 +1,109 @@
+#include <Algorithm/OrganizedPointCloud.h>
+#include <Algorithm/vtkQuantizingFilter.h>
+
+void OrganizedPointCloud::Resize(unsigned int width, unsigned int height)
+{
+    this->width = width;
+    this->height = height;
+
+    auto nop = GetNumberOfPoints();
+    x.assign(nop, 0.0f);
+    y.assign(nop, 0.0f);
+    z.assign(nop, 0.0f);
+    valid.assign(nop, 0);
+}
+
+bool OrganizedPointCloud::FromPolyData(vtkPolyData* grid, OrganizedPointCloud& cloud, float emptyDepth)
+{
+    unsigned int width = 0;
+    unsigned int height = 0;
+    if (false == vtkQuantizingFilter::GetGridDimensions(grid, width, height))
+        return false;
+
+    cloud.Resize(width, height);
+
+    auto points = grid->GetPoints();
+    vtkSMPTools::For(0, (vtkIdType)cloud.GetNumberOfPoints(), [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                double p[3];
+                points->GetPoint(i, p);
+                cloud.x[i] = (float)p[0];
+                cloud.y[i] = (float)p[1];
+                cloud.z[i] = (float)p[2];
+                cloud.valid[i] = emptyDepth != (float)p[2] ? 1 : 0;
+            }
+        });
+
+    return true;
+}
+
+void OrganizedPointCloud::FromDepths(const float* depths, unsigned int width, unsigned int height,
+    float wInterval, float hInterval, OrganizedPointCloud& cloud, float emptyDepth)
+{
+    cloud.Resize(width, height);
+
+    vtkSMPTools::For(0, (vtkIdType)height, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType h = begin; h < end; h++)
+            {
+                for (unsigned int w = 0; w < width; w++)
+                {
+                    auto i = cloud.Index(w, (unsigned int)h);
+                    cloud.x[i] = ((float)w - ((float)width * 0.5f)) * wInterval;
+                    cloud.y[i] = ((float)h - ((float)height * 0.5f)) * hInterval;
+                    cloud.z[i] = depths[i];
+                    cloud.valid[i] = emptyDepth != depths[i] ? 1 : 0;
+                }
+            }
+        });
+}
+
+size_t OrganizedPointCloud::GetNumberOfValidPoints() const
+{
+    return (size_t)std::count(valid.begin(), valid.end(), (unsigned char)1);
+}
+
+vtkSmartPointer<vtkPolyData> OrganizedPointCloud::ToPolyData(bool validOnly, float emptyDepth) const
+{
+    auto nop = GetNumberOfPoints();
+
+    vector<vtkIdType> pointMap;
+    vtkIdType numberOfOutputPoints = (vtkIdType)nop;
+    if (validOnly)
+    {
+        pointMap.resize(nop);
+        numberOfOutputPoints = 0;
+        for (size_t i = 0; i < nop; i++)
+        {
+            pointMap[i] = valid[i] ? numberOfOutputPoints++ : -1;
+        }
+    }
+
+    vtkNew<vtkPoints> points;
+    points->SetDataTypeToFloat();
+    points->SetNumberOfPoints(numberOfOutputPoints);
+    auto xyz = vtkFloatArray::FastDownCast(points->GetData())->GetPointer(0);
+
+    vtkSMPTools::For(0, (vtkIdType)nop, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                auto o = validOnly ? pointMap[i] : i;
+                if (o < 0) continue;
+
+                xyz[o * 3 + 0] = x[i];
+                xyz[o * 3 + 1] = y[i];
+                xyz[o * 3 + 2] = valid[i] ? z[i] : emptyDepth;
+            }
+        });
+
+    auto polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(points);
+    if (false == validOnly)
+    {
+        vtkQuantizingFilter::SetGridDimensions(polyData, width, height);
+    }
+    return polyData;
+}
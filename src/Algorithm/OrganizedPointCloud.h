@@ -0,0 +1,109 @@
+#pragma once
+
+#include <Common.h>
+
+// Point cloud that keeps the row/column layout of the scanner grid.
+// Coordinates are stored as float SoA, empty cells are flagged invalid instead of being removed,
+// so the neighbours of a cell are the cells around it and no spatial index has to be built.
+class OrganizedPointCloud
+{
+public:
+    // Iterates the valid cells of a square window around a cell, the center included.
+    class Neighborhood
+    {
+    public:
+        class Iterator
+        {
+        public:
+            Iterator(const Neighborhood* neighborhood, int col, int row)
+                : neighborhood(neighborhood), col(col), row(row) { SkipInvalid(); }
+
+            inline size_t operator*() const { return neighborhood->cloud->Index(col, row); }
+            inline Iterator& operator++() { Advance(); SkipInvalid(); return *this; }
+            inline bool operator==(const Iterator& other) const { return col == other.col && row == other.row; }
+            inline bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+        private:
+            const Neighborhood* neighborhood;
+            int col;
+            int row;
+
+            inline void Advance()
+            {
+                if (++col > neighborhood->col1)
+                {
+                    col = neighborhood->col0;
+                    row++;
+                }
+            }
+
+            inline void SkipInvalid()
+            {
+                while (row <= neighborhood->row1 && false == neighborhood->cloud->IsValid(neighborhood->cloud->Index(col, row)))
+                {
+                    Advance();
+                }
+            }
+        };
+
+        Neighborhood(const OrganizedPointCloud* cloud, unsigned int col, unsigned int row, int radius)
+            : cloud(cloud),
+            col0(std::max(0, (int)col - radius)), col1(std::min((int)cloud->GetWidth() - 1, (int)col + radius)),
+            row0(std::max(0, (int)row - radius)), row1(std::min((int)cloud->GetHeight() - 1, (int)row + radius)) {}
+
+        inline Iterator begin() const { return Iterator(this, col0, row0); }
+        inline Iterator end() const { return Iterator(this, col0, row1 + 1); }
+
+    private:
+        const OrganizedPointCloud* cloud;
+        int col0, col1, row0, row1;
+    };
+
+    OrganizedPointCloud() {}
+    OrganizedPointCloud(unsigned int width, unsigned int height) { Resize(width, height); }
+
+    void Resize(unsigned int width, unsigned int height);
+
+    // Reads an organized grid such as the vtkQuantizingFilter output, cells at emptyDepth become invalid.
+    static bool FromPolyData(vtkPolyData* grid, OrganizedPointCloud& cloud, float emptyDepth = -1000.0f);
+    static void FromDepths(const float* depths, unsigned int width, unsigned int height,
+        float wInterval, float hInterval, OrganizedPointCloud& cloud, float emptyDepth = -1000.0f);
+
+    // With validOnly the output is compact and loses its grid layout.
+    vtkSmartPointer<vtkPolyData> ToPolyData(bool validOnly = false, float emptyDepth = -1000.0f) const;
+
+    inline unsigned int GetWidth() const { return width; }
+    inline unsigned int GetHeight() const { return height; }
+    inline size_t GetNumberOfPoints() const { return (size_t)width * height; }
+    size_t GetNumberOfValidPoints() const;
+
+    inline size_t Index(unsigned int col, unsigned int row) const { return (size_t)row * width + col; }
+    inline unsigned int Col(size_t index) const { return (unsigned int)(index % width); }
+    inline unsigned int Row(size_t index) const { return (unsigned int)(index / width); }
+
+    inline bool IsValid(size_t index) const { return 0 != valid[index]; }
+    inline void SetValid(size_t index, bool isValid) { valid[index] = isValid ? 1 : 0; }
+
+    inline void GetPoint(size_t index, float* p) const { p[0] = x[index]; p[1] = y[index]; p[2] = z[index]; }
+    inline void SetPoint(size_t index, float px, float py, float pz) { x[index] = px; y[index] = py; z[index] = pz; valid[index] = 1; }
+
+    inline float* GetX() { return x.data(); }
+    inline float* GetY() { return y.data(); }
+    inline float* GetZ() { return z.data(); }
+    inline const float* GetX() const { return x.data(); }
+    inline const float* GetY() const { return y.data(); }
+    inline const float* GetZ() const { return z.data(); }
+    inline const unsigned char* GetValid() const { return valid.data(); }
+
+    inline Neighborhood GetNeighborhood(unsigned int col, unsigned int row, int radius) const { return Neighborhood(this, col, row, radius); }
+    inline Neighborhood GetNeighborhood(size_t index, int radius) const { return Neighborhood(this, Col(index), Row(index), radius); }
+
+private:
+    unsigned int width = 0;
+    unsigned int height = 0;
+
+    vector<float> x;
+    vector<float> y;
+    vector<float> z;
+    vector<unsigned char> valid;
+};
@@ -0,0 +1,113 @@
+#include <Algorithm/PointStatistics.h>
+
+void PointStatistics::Reset()
+{
+    count = 0;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        minimum[axis] = numeric_limits<double>::max();
+        maximum[axis] = numeric_limits<double>::lowest();
+        mean[axis] = 0.0;
+        m2[axis] = 0.0;
+    }
+}
+
+void PointStatistics::Add(const float* xyz, size_t numberOfPoints)
+{
+    vtkSMPThreadLocal<PointStatistics> localStatistics;
+    vtkSMPTools::For(0, (vtkIdType)numberOfPoints, [&](vtkIdType begin, vtkIdType end)
+        {
+            auto& statistics = localStatistics.Local();
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                statistics.count++;
+                auto n = (double)statistics.count;
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    double value = xyz[i * 3 + axis];
+                    statistics.minimum[axis] = std::min(statistics.minimum[axis], value);
+                    statistics.maximum[axis] = std::max(statistics.maximum[axis], value);
+
+                    auto delta = value - statistics.mean[axis];
+                    statistics.mean[axis] += delta / n;
+                    statistics.m2[axis] += delta * (value - statistics.mean[axis]);
+                }
+            }
+        });
+
+    for (auto& statistics : localStatistics)
+    {
+        Merge(statistics);
+    }
+}
+
+void PointStatistics::Add(vtkPoints* points)
+{
+    if (nullptr == points)
+        return;
+
+    if (auto floatArray = vtkFloatArray::FastDownCast(points->GetData()))
+    {
+        Add(floatArray->GetPointer(0), (size_t)points->GetNumberOfPoints());
+        return;
+    }
+
+    // Other point types are converted in bounded blocks
+    const vtkIdType blockSize = 1 << 16;
+    vector<float> xyz;
+    auto nop = points->GetNumberOfPoints();
+    for (vtkIdType first = 0; first < nop; first += blockSize)
+    {
+        auto count = std::min(blockSize, nop - first);
+        xyz.resize((size_t)count * 3);
+        for (vtkIdType i = 0; i < count; i++)
+        {
+            double p[3];
+            points->GetPoint(first + i, p);
+            for (int axis = 0; axis < 3; axis++) xyz[i * 3 + axis] = (float)p[axis];
+        }
+        Add(xyz.data(), (size_t)count);
+    }
+}
+
+void PointStatistics::Merge(const PointStatistics& other)
+{
+    if (0 == other.count)
+        return;
+
+    auto n = (double)count;
+    auto m = (double)other.count;
+    auto total = n + m;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        minimum[axis] = std::min(minimum[axis], other.minimum[axis]);
+        maximum[axis] = std::max(maximum[axis], other.maximum[axis]);
+
+        auto delta = other.mean[axis] - mean[axis];
+        mean[axis] += delta * m / total;
+        m2[axis] += other.m2[axis] + delta * delta * n * m / total;
+    }
+    count += other.count;
+}
+
+void PointStatistics::GetBounds(double bounds[6]) const
+{
+    for (int axis = 0; axis < 3; axis++)
+    {
+        bounds[axis * 2 + 0] = minimum[axis];
+        bounds[axis * 2 + 1] = maximum[axis];
+    }
+}
+
+void PointStatistics::GetMean(double mean[3]) const
+{
+    for (int axis = 0; axis < 3; axis++) mean[axis] = this->mean[axis];
+}
+
+void PointStatistics::GetStandardDeviation(double standardDeviation[3]) const
+{
+    for (int axis = 0; axis < 3; axis++)
+    {
+        standardDeviation[axis] = 1 < count ? std::sqrt(m2[axis] / (double)(count - 1)) : 0.0;
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Common.h>
+
+// Count, bounds, mean and standard deviation per axis, accumulated chunk by chunk.
+// Partial results are combined with the pairwise update of Chan et al., so the order chunks arrive in does not matter.
+class PointStatistics
+{
+public:
+    PointStatistics() { Reset(); }
+
+    void Reset();
+
+    void Add(const float* xyz, size_t numberOfPoints);
+    void Add(vtkPoints* points);
+    void Merge(const PointStatistics& other);
+
+    inline size_t GetNumberOfPoints() const { return count; }
+    void GetBounds(double bounds[6]) const;
+    void GetMean(double mean[3]) const;
+    void GetStandardDeviation(double standardDeviation[3]) const;
+
+private:
+    size_t count;
+    double minimum[3];
+    double maximum[3];
+    double mean[3];
+    // Sum of squared differences from the mean
+    double m2[3];
+};
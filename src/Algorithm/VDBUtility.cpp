@@ -0,0 +1,744 @@
+#include <Algorithm/VDBUtility.h>
+
+#include <Algorithm/Morton.h>
+#include <Algorithm/vtkParallelQuadricDecimation.h>
+
+#include <openvdb/tools/Composite.h>
+#include <openvdb/tools/FastSweeping.h>
+#include <openvdb/tools/Interpolation.h>
+#include <openvdb/tools/ParticlesToLevelSet.h>
+#include <openvdb/tools/VolumeToMesh.h>
+
+namespace
+{
+    // Three component tuples as packed floats, converted into storage unless they already are
+    const float* GetFloatTuples(vtkDataArray* array, vector<float>& storage)
+    {
+        if (auto floatArray = vtkFloatArray::FastDownCast(array))
+            return floatArray->GetPointer(0);
+
+        auto numberOfTuples = array->GetNumberOfTuples();
+        storage.resize((size_t)numberOfTuples * 3);
+        vtkSMPTools::For(0, numberOfTuples, [&](vtkIdType begin, vtkIdType end)
+            {
+                for (vtkIdType i = begin; i < end; i++)
+                {
+                    double t[3];
+                    array->GetTuple(i, t);
+                    for (int axis = 0; axis < 3; axis++) storage[i * 3 + axis] = (float)t[axis];
+                }
+            });
+        return storage.data();
+    }
+
+    // Points as packed floats
+    const float* GetFloatPoints(vtkPoints* points, vector<float>& storage)
+    {
+        return GetFloatTuples(points->GetData(), storage);
+    }
+
+    struct LeafVoxel
+    {
+        uint64_t leafKey;
+        openvdb::Coord coord;
+    };
+
+    // Morton order of the leaf origin, which keeps neighbouring leaves close in the sorted voxels
+    inline uint64_t LeafKey(const openvdb::Coord& coord)
+    {
+        const int32_t offset = 1 << 20;
+        return EncodeMorton(
+            (uint32_t)((coord.x() >> 3) + offset) & 0x1FFFFF,
+            (uint32_t)((coord.y() >> 3) + offset) & 0x1FFFFF,
+            (uint32_t)((coord.z() >> 3) + offset) & 0x1FFFFF);
+    }
+
+    struct LeafPoint
+    {
+        uint64_t leafKey;
+        openvdb::Coord origin;
+        size_t index;
+    };
+
+    // Adapter that lets ParticlesToLevelSet read packed float points
+    class FloatParticleList
+    {
+    public:
+        using PosType = openvdb::Vec3R;
+
+        FloatParticleList(const float* xyz, size_t numberOfPoints, openvdb::Real radius)
+            : xyz(xyz), numberOfPoints(numberOfPoints), radius(radius) {}
+
+        size_t size() const { return numberOfPoints; }
+
+        void getPos(size_t n, openvdb::Vec3R& position) const
+        {
+            position = openvdb::Vec3R(xyz[n * 3 + 0], xyz[n * 3 + 1], xyz[n * 3 + 2]);
+        }
+
+        void getPosRad(size_t n, openvdb::Vec3R& position, openvdb::Real& r) const
+        {
+            getPos(n, position);
+            r = radius;
+        }
+
+    private:
+        const float* xyz;
+        size_t numberOfPoints;
+        openvdb::Real radius;
+    };
+}
+
+openvdb::FloatGrid::Ptr VoxelizePoints(const float* xyz, size_t numberOfPoints, float voxelSize)
+{
+    using LeafType = openvdb::FloatTree::LeafNodeType;
+
+    auto grid = openvdb::FloatGrid::create(0.0f);
+    grid->setTransform(openvdb::math::Transform::createLinearTransform(voxelSize));
+    if (0 == numberOfPoints)
+        return grid;
+
+    const int32_t leafMask = ~int32_t(LeafType::DIM - 1);
+    auto& transform = grid->transform();
+    vector<LeafVoxel> voxels(numberOfPoints);
+    vtkSMPTools::For(0, (vtkIdType)numberOfPoints, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                openvdb::Vec3d point(xyz[i * 3 + 0], xyz[i * 3 + 1], xyz[i * 3 + 2]);
+                auto coord = transform.worldToIndexNodeCentered(point);
+                voxels[i] = { LeafKey(coord), coord };
+            }
+        });
+
+    // Ties on the key are broken by the origin itself, so a leaf is contiguous even if two origins share a key
+    vtkSMPTools::Sort(voxels.begin(), voxels.end(), [&](const LeafVoxel& a, const LeafVoxel& b)
+        {
+            if (a.leafKey != b.leafKey) return a.leafKey < b.leafKey;
+            return (a.coord & leafMask) < (b.coord & leafMask);
+        });
+
+    vector<size_t> leafBegins;
+    for (size_t i = 0; i < numberOfPoints; i++)
+    {
+        if (0 == i || (voxels[i].coord & leafMask) != (voxels[i - 1].coord & leafMask))
+        {
+            leafBegins.push_back(i);
+        }
+    }
+    leafBegins.push_back(numberOfPoints);
+
+    auto numberOfLeaves = leafBegins.size() - 1;
+    vector<LeafType*> leaves(numberOfLeaves);
+    vtkSMPTools::For(0, (vtkIdType)numberOfLeaves, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType l = begin; l < end; l++)
+            {
+                auto leaf = new LeafType(voxels[leafBegins[l]].coord, 0.0f);
+                for (auto i = leafBegins[l]; i < leafBegins[l + 1]; i++)
+                {
+                    leaf->setValueOn(voxels[i].coord, 1.0f);
+                }
+                leaves[l] = leaf;
+            }
+        });
+
+    // The tree takes ownership of the leaves, only the internal nodes above them are created here
+    auto& tree = grid->tree();
+    for (auto leaf : leaves)
+    {
+        tree.addLeaf(leaf);
+    }
+
+    return grid;
+}
+
+openvdb::FloatGrid::Ptr PointsToLevelSet(const float* xyz, size_t numberOfPoints,
+    float voxelSize, float radius, float halfWidth)
+{
+    auto grid = openvdb::createLevelSet<openvdb::FloatGrid>(voxelSize, halfWidth);
+    if (0 == numberOfPoints)
+        return grid;
+
+    FloatParticleList particles(xyz, numberOfPoints, std::max(radius, 1.5f * voxelSize));
+
+    openvdb::tools::ParticlesToLevelSet<openvdb::FloatGrid> raster(*grid);
+    raster.rasterizeSpheres(particles);
+    raster.finalize(true);
+    return grid;
+}
+
+openvdb::FloatGrid::Ptr PointsToSDF(const float* xyz, const float* normals, size_t numberOfPoints,
+    float voxelSize, float halfWidth)
+{
+    using LeafType = openvdb::FloatTree::LeafNodeType;
+
+    auto grid = openvdb::createLevelSet<openvdb::FloatGrid>(voxelSize, halfWidth);
+    if (0 == numberOfPoints)
+        return grid;
+
+    // Splat radius in voxels, wide enough that every point puts voxels on both sides of its plane
+    const float radius = 1.5f;
+    const float background = grid->background();
+    const int32_t leafMask = ~int32_t(LeafType::DIM - 1);
+    auto& transform = grid->transform();
+
+    // Index space positions, unit normals and the number of leaves each splat reaches
+    vector<openvdb::Vec3s> positions(numberOfPoints);
+    vector<openvdb::Vec3s> unitNormals(numberOfPoints);
+    vector<size_t> firstEntry(numberOfPoints + 1, 0);
+    vtkSMPTools::For(0, (vtkIdType)numberOfPoints, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                openvdb::Vec3d point(xyz[i * 3 + 0], xyz[i * 3 + 1], xyz[i * 3 + 2]);
+                positions[i] = openvdb::Vec3s(transform.worldToIndex(point));
+
+                openvdb::Vec3s normal(normals[i * 3 + 0], normals[i * 3 + 1], normals[i * 3 + 2]);
+                auto length = normal.length();
+                if (false == (1e-6f < length))
+                {
+                    // Points without a usable normal carry no sign and are left out
+                    firstEntry[i + 1] = 0;
+                    continue;
+                }
+                unitNormals[i] = normal / length;
+
+                auto lo = openvdb::Coord::floor(positions[i] - openvdb::Vec3s(radius)) & leafMask;
+                auto hi = openvdb::Coord::floor(positions[i] + openvdb::Vec3s(radius)) & leafMask;
+                auto count = (hi - lo).asVec3i() / LeafType::DIM + openvdb::Vec3i(1);
+                firstEntry[i + 1] = (size_t)(count.x() * count.y() * count.z());
+            }
+        });
+    for (size_t i = 0; i < numberOfPoints; i++)
+    {
+        firstEntry[i + 1] += firstEntry[i];
+    }
+
+    // One entry per point and leaf it reaches, almost always just one
+    vector<LeafPoint> entries(firstEntry[numberOfPoints]);
+    vtkSMPTools::For(0, (vtkIdType)numberOfPoints, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                if (firstEntry[i] == firstEntry[i + 1])
+                    continue;
+
+                auto lo = openvdb::Coord::floor(positions[i] - openvdb::Vec3s(radius)) & leafMask;
+                auto hi = openvdb::Coord::floor(positions[i] + openvdb::Vec3s(radius)) & leafMask;
+                auto entry = firstEntry[i];
+                for (auto x = lo.x(); x <= hi.x(); x += LeafType::DIM)
+                    for (auto y = lo.y(); y <= hi.y(); y += LeafType::DIM)
+                        for (auto z = lo.z(); z <= hi.z(); z += LeafType::DIM)
+                        {
+                            openvdb::Coord origin(x, y, z);
+                            entries[entry++] = { LeafKey(origin), origin, (size_t)i };
+                        }
+            }
+        });
+
+    vtkSMPTools::Sort(entries.begin(), entries.end(), [](const LeafPoint& a, const LeafPoint& b)
+        {
+            if (a.leafKey != b.leafKey) return a.leafKey < b.leafKey;
+            return a.origin < b.origin;
+        });
+
+    vector<size_t> leafBegins;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (0 == i || entries[i].origin != entries[i - 1].origin)
+        {
+            leafBegins.push_back(i);
+        }
+    }
+    leafBegins.push_back(entries.size());
+
+    // Every voxel takes the plane distance of its closest point, each leaf is written by one thread
+    auto numberOfLeaves = leafBegins.size() - 1;
+    vector<LeafType*> leaves(numberOfLeaves, nullptr);
+    vtkSMPTools::For(0, (vtkIdType)numberOfLeaves, [&](vtkIdType begin, vtkIdType end)
+        {
+            vector<float> closest(LeafType::SIZE);
+            for (vtkIdType l = begin; l < end; l++)
+            {
+                auto origin = entries[leafBegins[l]].origin;
+                auto last = origin.offsetBy(LeafType::DIM - 1);
+                auto leaf = new LeafType(origin, background);
+                std::fill(closest.begin(), closest.end(), std::numeric_limits<float>::max());
+
+                for (auto e = leafBegins[l]; e < leafBegins[l + 1]; e++)
+                {
+                    auto i = entries[e].index;
+                    auto& p = positions[i];
+                    auto& n = unitNormals[i];
+
+                    auto lo = openvdb::Coord::maxComponent(openvdb::Coord::ceil(p - openvdb::Vec3s(radius)), origin);
+                    auto hi = openvdb::Coord::minComponent(openvdb::Coord::floor(p + openvdb::Vec3s(radius)), last);
+                    for (auto x = lo.x(); x <= hi.x(); x++)
+                        for (auto y = lo.y(); y <= hi.y(); y++)
+                            for (auto z = lo.z(); z <= hi.z(); z++)
+                            {
+                                openvdb::Vec3s d(x - p.x(), y - p.y(), z - p.z());
+                                auto distance2 = d.lengthSqr();
+                                if (radius * radius < distance2)
+                                    continue;
+
+                                auto offset = LeafType::coordToOffset(openvdb::Coord(x, y, z));
+                                if (closest[offset] <= distance2)
+                                    continue;
+
+                                closest[offset] = distance2;
+                                auto sdf = d.dot(n) * voxelSize;
+                                leaf->setValueOn(offset, std::max(-background, std::min(background, sdf)));
+                            }
+                }
+
+                if (leaf->isEmpty())
+                {
+                    delete leaf;
+                    leaf = nullptr;
+                }
+                leaves[l] = leaf;
+            }
+        });
+
+    auto& tree = grid->tree();
+    for (auto leaf : leaves)
+    {
+        if (nullptr != leaf)
+            tree.addLeaf(leaf);
+    }
+
+    // The splat is only a distance right next to the points, fast sweeping turns it into a true distance
+    // from its zero crossing and then grows the band out to halfWidth
+    auto sdf = openvdb::tools::sdfToSdf(*grid);
+    auto dilation = (int)std::ceil(halfWidth - radius);
+    if (0 < dilation)
+        sdf = openvdb::tools::dilateSdf(*sdf, dilation, openvdb::tools::NN_FACE_EDGE);
+
+    sdf->setGridClass(openvdb::GRID_LEVEL_SET);
+    return sdf;
+}
+
+openvdb::FloatGrid::Ptr DepthsToSDF(const float* depths, unsigned int imageWidth, unsigned int imageHeight,
+    float wInterval, float hInterval, float voxelSize, float halfWidth, float emptyDepth)
+{
+    auto grid = openvdb::createLevelSet<openvdb::FloatGrid>(voxelSize, halfWidth);
+    if (nullptr == depths || 0 == imageWidth || 0 == imageHeight)
+        return grid;
+
+    // First voxel whose center lies in a cell, cell w spans from the grid point of w to the one of w + 1.
+    // Neighbouring cells share the edge computation, so every voxel column belongs to exactly one cell.
+    auto firstColumn = [&](int cell, unsigned int size, float interval)
+        {
+            return (int)std::ceil((((float)cell - ((float)size * 0.5f)) * interval) / voxelSize);
+        };
+
+    const float truncation = grid->background();
+    vtkSMPThreadLocal<openvdb::FloatGrid::Ptr> localGrids;
+    vtkSMPTools::For(0, (vtkIdType)imageHeight, [&](vtkIdType begin, vtkIdType end)
+        {
+            auto& local = localGrids.Local();
+            if (nullptr == local)
+                local = openvdb::createLevelSet<openvdb::FloatGrid>(voxelSize, halfWidth);
+            auto accessor = local->getAccessor();
+
+            for (vtkIdType h = begin; h < end; h++)
+            {
+                auto j0 = firstColumn((int)h, imageHeight, hInterval);
+                auto j1 = firstColumn((int)h + 1, imageHeight, hInterval);
+                if (j0 == j1)
+                    continue;
+
+                for (unsigned int w = 0; w < imageWidth; w++)
+                {
+                    auto depth = depths[(size_t)h * imageWidth + w];
+                    if (emptyDepth == depth)
+                        continue;
+
+                    auto i0 = firstColumn((int)w, imageWidth, wInterval);
+                    auto i1 = firstColumn((int)w + 1, imageWidth, wInterval);
+                    auto k0 = (int)std::ceil((depth - truncation) / voxelSize);
+                    auto k1 = (int)std::floor((depth + truncation) / voxelSize);
+                    for (auto i = i0; i < i1; i++)
+                        for (auto j = j0; j < j1; j++)
+                            for (auto k = k0; k <= k1; k++)
+                            {
+                                auto sdf = depth - (float)k * voxelSize;
+                                accessor.setValue(openvdb::Coord(i, j, k), std::max(-truncation, std::min(truncation, sdf)));
+                            }
+                }
+            }
+        });
+
+    // Rows of different threads never share a voxel, so merging the thread grids is a plain union
+    for (auto& local : localGrids)
+    {
+        if (nullptr != local)
+            grid->tree().merge(local->tree(), openvdb::MERGE_ACTIVE_STATES);
+    }
+    return grid;
+}
+
+VDBVoxelizer::VDBVoxelizer(float voxelSize)
+    : grid(openvdb::FloatGrid::create(0.0f))
+{
+    grid->setTransform(openvdb::math::Transform::createLinearTransform(voxelSize));
+}
+
+void VDBVoxelizer::Add(const float* xyz, size_t numberOfPoints)
+{
+    auto chunk = VoxelizePoints(xyz, numberOfPoints, (float)grid->voxelSize()[0]);
+    // Both grids only hold 1 over a background of 0, so the maximum is the union
+    openvdb::tools::compMax(*grid, *chunk);
+    this->numberOfPoints += numberOfPoints;
+}
+
+void VDBVoxelizer::Add(vtkPoints* points)
+{
+    if (nullptr == points)
+        return;
+
+    vector<float> storage;
+    Add(GetFloatPoints(points, storage), (size_t)points->GetNumberOfPoints());
+}
+
+openvdb::FloatGrid::Ptr CreateVDBVolume(vtkPolyData* polyData, float voxelSize, float narrowBandWidth, float radius)
+{
+    if (nullptr == polyData || nullptr == polyData->GetPoints())
+    {
+        return 0.0f < narrowBandWidth
+            ? openvdb::createLevelSet<openvdb::FloatGrid>(voxelSize, narrowBandWidth)
+            : VoxelizePoints(nullptr, 0, voxelSize);
+    }
+
+    auto points = polyData->GetPoints();
+    vector<float> storage;
+    auto xyz = GetFloatPoints(points, storage);
+    auto nop = (size_t)points->GetNumberOfPoints();
+
+    auto normalArray = polyData->GetPointData()->GetNormals();
+    if (0.0f < narrowBandWidth && nullptr != normalArray && 3 == normalArray->GetNumberOfComponents()
+        && normalArray->GetNumberOfTuples() == (vtkIdType)nop)
+    {
+        vector<float> normalStorage;
+        return PointsToSDF(xyz, GetFloatTuples(normalArray, normalStorage), nop, voxelSize, narrowBandWidth);
+    }
+
+    if (0.0f < narrowBandWidth)
+        return PointsToLevelSet(xyz, nop, voxelSize, radius, narrowBandWidth);
+    return VoxelizePoints(xyz, nop, voxelSize);
+}
+
+namespace
+{
+    // Frees the point buffer of a VolumeToMesh once VTK is done with it
+    void DeleteVDBPoints(void* points)
+    {
+        delete[] static_cast<openvdb::Vec3s*>(points);
+    }
+}
+
+vtkSmartPointer<vtkPolyData> VDBToMesh(openvdb::FloatGrid::Ptr grid, double isovalue, double adaptivity, bool triangulate)
+{
+    openvdb::tools::VolumeToMesh mesher(isovalue, adaptivity);
+    mesher(*grid);
+
+    // The mesher's point buffer becomes the point array as it is, Vec3s being three packed floats
+    static_assert(sizeof(openvdb::Vec3s) == 3 * sizeof(float), "Vec3s has to be three packed floats");
+    auto numberOfPoints = (vtkIdType)mesher.pointListSize();
+    vtkNew<vtkFloatArray> pointArray;
+    pointArray->SetNumberOfComponents(3);
+    if (0 < numberOfPoints)
+    {
+        auto pointList = mesher.pointList().release();
+        pointArray->SetArray(reinterpret_cast<float*>(pointList), numberOfPoints * 3, 0,
+            vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+        pointArray->SetArrayFreeFunction(DeleteVDBPoints);
+    }
+
+    vtkNew<vtkPoints> points;
+    points->SetData(pointArray);
+
+    // Every polygon pool owns a range of cells and connectivity known from its counts, so pools are filled in parallel
+    auto& pools = mesher.polygonPoolList();
+    auto numberOfPools = mesher.polygonPoolListSize();
+    vtkIdType cellsPerQuad = triangulate ? 2 : 1;
+    vtkIdType indicesPerQuad = triangulate ? 6 : 4;
+
+    vector<vtkIdType> firstCell(numberOfPools + 1, 0);
+    vector<vtkIdType> firstIndex(numberOfPools + 1, 0);
+    for (size_t p = 0; p < numberOfPools; p++)
+    {
+        auto numberOfTriangles = (vtkIdType)pools[p].numTriangles();
+        auto numberOfQuads = (vtkIdType)pools[p].numQuads();
+        firstCell[p + 1] = firstCell[p] + numberOfTriangles + cellsPerQuad * numberOfQuads;
+        firstIndex[p + 1] = firstIndex[p] + 3 * numberOfTriangles + indicesPerQuad * numberOfQuads;
+    }
+
+    auto numberOfCells = firstCell[numberOfPools];
+    vtkNew<vtkIdTypeArray> offsets;
+    offsets->SetNumberOfTuples(numberOfCells + 1);
+    auto offsetPointer = offsets->GetPointer(0);
+    offsetPointer[numberOfCells] = firstIndex[numberOfPools];
+
+    vtkNew<vtkIdTypeArray> connectivity;
+    connectivity->SetNumberOfTuples(firstIndex[numberOfPools]);
+    auto connectivityPointer = connectivity->GetPointer(0);
+
+    vtkSMPTools::For(0, (vtkIdType)numberOfPools, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType p = begin; p < end; p++)
+            {
+                auto& pool = pools[p];
+                auto cell = firstCell[p];
+                auto index = firstIndex[p];
+
+                for (size_t t = 0; t < pool.numTriangles(); t++)
+                {
+                    auto& triangle = pool.triangle(t);
+                    offsetPointer[cell++] = index;
+                    connectivityPointer[index++] = triangle[0];
+                    connectivityPointer[index++] = triangle[1];
+                    connectivityPointer[index++] = triangle[2];
+                }
+
+                for (size_t q = 0; q < pool.numQuads(); q++)
+                {
+                    auto& quad = pool.quad(q);
+                    if (triangulate)
+                    {
+                        offsetPointer[cell++] = index;
+                        connectivityPointer[index++] = quad[0];
+                        connectivityPointer[index++] = quad[1];
+                        connectivityPointer[index++] = quad[2];
+                        offsetPointer[cell++] = index;
+                        connectivityPointer[index++] = quad[2];
+                        connectivityPointer[index++] = quad[3];
+                        connectivityPointer[index++] = quad[0];
+                    }
+                    else
+                    {
+                        offsetPointer[cell++] = index;
+                        connectivityPointer[index++] = quad[0];
+                        connectivityPointer[index++] = quad[1];
+                        connectivityPointer[index++] = quad[2];
+                        connectivityPointer[index++] = quad[3];
+                    }
+                }
+            }
+        });
+
+    vtkNew<vtkCellArray> polys;
+    polys->SetData(offsets, connectivity);
+
+    auto polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(points);
+    polyData->SetPolys(polys);
+    return polyData;
+}
+
+namespace
+{
+    // Largest distance of the vertices and cell centroids of a mesh from the surface of the finest LOD.
+    // The static cell locator answers closest point queries from several threads once it is built.
+    double MeshError(vtkStaticCellLocator* finest, vtkPolyData* mesh)
+    {
+        auto polys = mesh->GetPolys();
+        auto points = mesh->GetPoints();
+        if (nullptr == polys || nullptr == points)
+            return 0.0;
+
+        // Squared distances until the end
+        vtkSMPThreadLocal<double> localError(0.0);
+        vtkSMPThreadLocalObject<vtkGenericCell> cells;
+        auto measure = [&](const double* p, double& error)
+        {
+            double closest[3];
+            vtkIdType cellId;
+            int subId;
+            double distance2 = 0.0;
+            finest->FindClosestPoint(p, closest, cells.Local(), cellId, subId, distance2);
+            if (0 <= cellId)
+                error = std::max(error, distance2);
+        };
+
+        vtkSMPTools::For(0, mesh->GetNumberOfPoints(), [&](vtkIdType begin, vtkIdType end)
+            {
+                double& error = localError.Local();
+                for (vtkIdType i = begin; i < end; i++)
+                {
+                    double p[3];
+                    points->GetPoint(i, p);
+                    measure(p, error);
+                }
+            });
+
+        // Vertices of a coarse LOD sit on the surface, the flat cells between them are what strays from it
+        vtkSMPThreadLocalObject<vtkIdList> cellPoints;
+        vtkSMPTools::For(0, polys->GetNumberOfCells(), [&](vtkIdType begin, vtkIdType end)
+            {
+                auto ids = cellPoints.Local();
+                double& error = localError.Local();
+                for (vtkIdType c = begin; c < end; c++)
+                {
+                    vtkIdType npts;
+                    const vtkIdType* pts;
+                    polys->GetCellAtId(c, npts, pts, ids);
+                    if (0 == npts)
+                        continue;
+
+                    double centroid[3] = { 0.0, 0.0, 0.0 };
+                    for (vtkIdType i = 0; i < npts; i++)
+                    {
+                        double p[3];
+                        points->GetPoint(pts[i], p);
+                        for (int axis = 0; axis < 3; axis++) centroid[axis] += p[axis] / (double)npts;
+                    }
+                    measure(centroid, error);
+                }
+            });
+
+        double error = 0.0;
+        for (auto e : localError)
+        {
+            error = std::max(error, e);
+        }
+        return std::sqrt(error);
+    }
+}
+
+vector<MeshLOD> VDBToMeshLODs(openvdb::FloatGrid::Ptr grid, double isovalue, double adaptivity,
+    const vector<double>& reductions)
+{
+    vector<MeshLOD> lods(reductions.size());
+    for (size_t i = 0; i < lods.size(); i++)
+    {
+        lods[i].reduction = std::clamp(reductions[i], 0.0, 1.0);
+    }
+    std::sort(lods.begin(), lods.end(), [](const MeshLOD& a, const MeshLOD& b) { return a.reduction < b.reduction; });
+
+    if (nullptr == grid || lods.empty())
+        return lods;
+
+    // The grid is meshed once, every coarser LOD decimates the one before it.
+    // The levels are built one after the other so the mesher and the decimation each get all the threads.
+    auto finest = VDBToMesh(grid, isovalue, adaptivity, true);
+    auto numberOfTriangles = finest->GetNumberOfPolys();
+
+    vtkNew<vtkStaticCellLocator> locator;
+    if (0 < numberOfTriangles)
+    {
+        locator->SetDataSet(finest);
+        locator->BuildLocator();
+    }
+
+    vtkSmartPointer<vtkPolyData> previous = finest;
+    for (auto& lod : lods)
+    {
+        auto targetNumberOfTriangles = (vtkIdType)std::llround((1.0 - lod.reduction) * (double)numberOfTriangles);
+        if (0 == numberOfTriangles || previous->GetNumberOfPolys() <= targetNumberOfTriangles)
+        {
+            lod.mesh = previous;
+        }
+        else
+        {
+            vtkNew<vtkParallelQuadricDecimation> decimation;
+            decimation->SetInputData(previous);
+            decimation->SetTargetNumberOfTriangles(std::max((vtkIdType)1, targetNumberOfTriangles));
+            decimation->Update();
+            lod.mesh = decimation->GetOutput();
+        }
+
+        lod.geometricError = lod.mesh == finest || 0 == numberOfTriangles ? 0.0 : MeshError(locator, lod.mesh);
+        previous = lod.mesh;
+    }
+    return lods;
+}
+
+size_t SelectLOD(const vector<MeshLOD>& lods, double distance, double viewAngle, int viewportHeight,
+    double pixelTolerance)
+{
+    if (lods.empty())
+        return 0;
+
+    // Pixels covered by one world unit at distance
+    auto halfHeight = std::max(distance, 1e-6) * std::tan(vtkMath::RadiansFromDegrees(viewAngle) * 0.5);
+    auto pixelsPerUnit = viewportHeight / (2.0 * halfHeight);
+
+    size_t selected = 0;
+    for (size_t i = 0; i < lods.size(); i++)
+    {
+        if (lods[i].geometricError * pixelsPerUnit <= pixelTolerance)
+            selected = i;
+    }
+    return selected;
+}
+
+namespace
+{
+    const char* CompressionNames[] = { "none", "zip", "blosc" };
+}
+
+const char* GetVDBCompressionName(VDBCompression compression)
+{
+    return CompressionNames[(int)compression];
+}
+
+bool ParseVDBCompression(const string& name, VDBCompression& compression)
+{
+    auto it = std::find_if(std::begin(CompressionNames), std::end(CompressionNames),
+        [&](const char* compressionName) { return name == compressionName; });
+    if (std::end(CompressionNames) == it)
+        return false;
+    compression = (VDBCompression)(it - std::begin(CompressionNames));
+    return true;
+}
+
+bool WriteVDB(openvdb::FloatGrid::Ptr grid, const std::string& filePath, VDBCompression compression)
+{
+    if (nullptr == grid)
+        return false;
+
+    uint32_t flags = openvdb::io::COMPRESS_ACTIVE_MASK;
+    if (VDBCompression::Blosc == compression && openvdb::io::Archive::hasBloscCompression())
+        flags |= openvdb::io::COMPRESS_BLOSC;
+    else if (VDBCompression::None != compression)
+        flags |= openvdb::io::COMPRESS_ZIP;
+
+    try
+    {
+        openvdb::GridPtrVec grids;
+        grids.push_back(grid);
+
+        openvdb::io::File file(filePath);
+        file.setCompression(flags);
+        file.write(grids);
+        file.close();
+    }
+    catch (const openvdb::Exception&)
+    {
+        return false;
+    }
+    return true;
+}
+
+openvdb::FloatGrid::Ptr ReadVDB(const std::string& filePath, bool delayLoad)
+{
+    try
+    {
+        openvdb::io::File file(filePath);
+        file.open(delayLoad);
+        auto grids = file.getGrids();
+        // Delay loaded leaves keep their own reference to the mapped file, closing it here is fine
+        file.close();
+
+        if (nullptr == grids || grids->empty())
+            return nullptr;
+        return openvdb::gridPtrCast<openvdb::FloatGrid>(grids->front());
+    }
+    catch (const openvdb::Exception&)
+    {
+        return nullptr;
+    }
+}
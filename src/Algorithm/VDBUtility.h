@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Common.h>
+
+#include <openvdb/openvdb.h>
+
+// Sets the voxel of every point to 1 on all cores.
+// Voxel coordinates are sorted by leaf node, each leaf is built by one thread and the leaves are then added to the tree.
+openvdb::FloatGrid::Ptr VoxelizePoints(const float* xyz, size_t numberOfPoints, float voxelSize = 0.1f);
+
+// Narrow-band level set of spheres of the given radius around the points, rasterized by
+// openvdb::tools::ParticlesToLevelSet. halfWidth is in voxels, radii below 1.5 voxels are raised to 1.5 voxels
+// since the rasterizer skips smaller particles.
+openvdb::FloatGrid::Ptr PointsToLevelSet(const float* xyz, size_t numberOfPoints,
+    float voxelSize, float radius, float halfWidth = 3.0f);
+
+// Narrow-band signed distance field of an oriented cloud. Each point splats its plane distance into the voxels
+// around it in parallel by leaf node, then fast sweeping solves the distance from the zero crossing out to halfWidth voxels.
+// Normals point to the outside, points with a zero normal are skipped.
+openvdb::FloatGrid::Ptr PointsToSDF(const float* xyz, const float* normals, size_t numberOfPoints,
+    float voxelSize, float halfWidth = 3.0f);
+
+// Truncated signed distance field of a quantized depth buffer, rasterized without going through points.
+// The grid is viewed along +z, so every voxel column takes the distance to the depth of the cell its center falls into,
+// positive in front of the surface, down to halfWidth voxels on both sides. Rows are processed in parallel.
+// Only the band is observed, so the far side of it closes the surface as a slab of that thickness.
+openvdb::FloatGrid::Ptr DepthsToSDF(const float* depths, unsigned int imageWidth, unsigned int imageHeight,
+    float wInterval, float hInterval, float voxelSize = 0.1f, float halfWidth = 3.0f, float emptyDepth = -1000.0f);
+
+// Voxelizes a cloud a chunk at a time, so clouds that never fit in memory can be voxelized.
+class VDBVoxelizer
+{
+public:
+    VDBVoxelizer(float voxelSize = 0.1f);
+
+    void Add(const float* xyz, size_t numberOfPoints);
+    void Add(vtkPoints* points);
+
+    inline openvdb::FloatGrid::Ptr GetGrid() const { return grid; }
+    inline size_t GetNumberOfPoints() const { return numberOfPoints; }
+
+private:
+    openvdb::FloatGrid::Ptr grid;
+    size_t numberOfPoints = 0;
+};
+
+// Voxelizes a whole cloud in one go, as occupancy or, with a narrowBandWidth in voxels, as a level set.
+// The level set is a signed distance field when the points have normals, and spheres of radius otherwise.
+openvdb::FloatGrid::Ptr CreateVDBVolume(vtkPolyData* polyData, float voxelSize = 0.1f,
+    float narrowBandWidth = 0.0f, float radius = 0.0f);
+
+// Extracts the isosurface of a grid as triangles and quads, or triangles only with triangulate.
+// The points are the mesher's own buffer, handed to VTK without a copy, and the cells are built in parallel.
+vtkSmartPointer<vtkPolyData> VDBToMesh(openvdb::FloatGrid::Ptr grid, double isovalue = 0.5, double adaptivity = 0.0,
+    bool triangulate = false);
+
+struct MeshLOD
+{
+    // Fraction of the finest LOD's triangles removed
+    double reduction = 0.0;
+    // Largest world space distance from the finest LOD's surface, sampled at the vertices and cell centroids
+    double geometricError = 0.0;
+    vtkSmartPointer<vtkPolyData> mesh;
+};
+
+// Meshes the grid once as triangles at adaptivity and decimates that mesh to every reduction, finest first.
+// Each LOD is decimated from the previous one, so the coarse levels never go back to the grid.
+vector<MeshLOD> VDBToMeshLODs(openvdb::FloatGrid::Ptr grid, double isovalue = 0.5, double adaptivity = 0.0,
+    const vector<double>& reductions = { 0.0, 0.75, 0.9375 });
+
+// Coarsest LOD whose error projects to at most pixelTolerance pixels at distance, for a perspective camera with a
+// vertical viewAngle in degrees over viewportHeight pixels
+size_t SelectLOD(const vector<MeshLOD>& lods, double distance, double viewAngle, int viewportHeight,
+    double pixelTolerance = 1.0);
+
+enum class VDBCompression
+{
+    None = 0,
+    Zip,
+    // Falls back to zip when OpenVDB was built without blosc
+    Blosc
+};
+
+const char* GetVDBCompressionName(VDBCompression compression);
+bool ParseVDBCompression(const string& name, VDBCompression& compression);
+
+// Single float grid .vdb files. Inactive values are always dropped on write.
+bool WriteVDB(openvdb::FloatGrid::Ptr grid, const std::string& filePath, VDBCompression compression = VDBCompression::Blosc);
+// With delayLoad only the topology is read up front, and leaf values are read from the memory mapped file
+// when they are first touched, so the file has to stay in place while the grid is in use.
+openvdb::FloatGrid::Ptr ReadVDB(const std::string& filePath, bool delayLoad = true);
@@ -0,0 +1,153 @@
+#include <Algorithm/VolumeFilter.h>
+
+#include <openvdb/tools/Filter.h>
+#include <openvdb/tools/LevelSetFilter.h>
+#include <openvdb/tools/Morphology.h>
+#include <openvdb/tools/Prune.h>
+#include <openvdb/tools/ValueTransformer.h>
+
+namespace
+{
+    const char* OperationNames[] = { "dilate", "erode", "gaussian", "mean", "median", "renormalize" };
+
+    // Sets the voxels that were not active before a dilation to 1, foreach gives every thread its own copy
+    struct MarkDilated
+    {
+        MarkDilated(const openvdb::MaskTree& before) : accessor(before) {}
+
+        inline void operator()(const openvdb::FloatGrid::ValueOnIter& iter) const
+        {
+            if (false == accessor.isValueOn(iter.getCoord()))
+                iter.setValue(1.0f);
+        }
+
+        openvdb::tree::ValueAccessor<const openvdb::MaskTree> accessor;
+    };
+
+    void FilterLevelSet(openvdb::FloatGrid& grid, const VolumeStep& step)
+    {
+        openvdb::tools::LevelSetFilter<openvdb::FloatGrid> filter(grid);
+        auto distance = (float)(step.width * grid.voxelSize()[0]);
+        for (int i = 0; i < step.iterations; i++)
+        {
+            switch (step.operation)
+            {
+            // Level sets are negative inside, so a negative offset grows the surface
+            case VolumeOperation::Dilate: filter.offset(-distance); break;
+            case VolumeOperation::Erode: filter.offset(distance); break;
+            case VolumeOperation::Gaussian: filter.gaussian(step.width); break;
+            case VolumeOperation::Mean: filter.mean(step.width); break;
+            case VolumeOperation::Median: filter.median(step.width); break;
+            case VolumeOperation::Renormalize: filter.normalize(); break;
+            default: break;
+            }
+        }
+    }
+
+    void FilterOccupancy(openvdb::FloatGrid& grid, const VolumeStep& step)
+    {
+        auto& tree = grid.tree();
+        switch (step.operation)
+        {
+        case VolumeOperation::Dilate:
+        {
+            openvdb::MaskTree before(tree, false, openvdb::TopologyCopy());
+            openvdb::tools::dilateActiveValues(tree, step.width * step.iterations,
+                openvdb::tools::NN_FACE_EDGE, openvdb::tools::IGNORE_TILES);
+            MarkDilated markDilated(before);
+            openvdb::tools::foreach(grid.beginValueOn(), markDilated, true, false);
+            break;
+        }
+        case VolumeOperation::Erode:
+        {
+            openvdb::tools::erodeActiveValues(tree, step.width * step.iterations,
+                openvdb::tools::NN_FACE_EDGE, openvdb::tools::IGNORE_TILES);
+            // Eroded voxels keep their value, the mesher would still see them without resetting it
+            auto background = grid.background();
+            openvdb::tools::foreach(grid.beginValueOff(), [background](const openvdb::FloatGrid::ValueOffIter& iter)
+                {
+                    iter.setValue(background);
+                });
+            openvdb::tools::pruneInactive(tree);
+            break;
+        }
+        case VolumeOperation::Gaussian:
+        case VolumeOperation::Mean:
+        case VolumeOperation::Median:
+        {
+            openvdb::tools::Filter<openvdb::FloatGrid> filter(grid);
+            if (VolumeOperation::Gaussian == step.operation) filter.gaussian(step.width, step.iterations);
+            else if (VolumeOperation::Mean == step.operation) filter.mean(step.width, step.iterations);
+            else filter.median(step.width, step.iterations);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+const char* GetVolumeOperationName(VolumeOperation operation)
+{
+    return OperationNames[(int)operation];
+}
+
+bool ParseVolumeSteps(const string& text, vector<VolumeStep>& steps)
+{
+    steps.clear();
+    stringstream ss(text);
+    string token;
+    while (std::getline(ss, token, ','))
+    {
+        stringstream tokenStream(token);
+        string name, width, iterations;
+        std::getline(tokenStream, name, ':');
+        std::getline(tokenStream, width, ':');
+        std::getline(tokenStream, iterations, ':');
+
+        auto it = std::find_if(std::begin(OperationNames), std::end(OperationNames),
+            [&](const char* operationName) { return name == operationName; });
+        if (std::end(OperationNames) == it)
+            return false;
+
+        VolumeStep step;
+        step.operation = (VolumeOperation)(it - std::begin(OperationNames));
+        try
+        {
+            if (false == width.empty()) step.width = std::stoi(width);
+            if (false == iterations.empty()) step.iterations = std::stoi(iterations);
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+        if (step.width < 1 || step.iterations < 1)
+            return false;
+        steps.push_back(step);
+    }
+    return false == steps.empty();
+}
+
+void FilterVolume(openvdb::FloatGrid& grid, const vector<VolumeStep>& steps, vector<VolumeStepReport>* reports)
+{
+    bool levelSet = openvdb::GRID_LEVEL_SET == grid.getGridClass();
+    for (auto& step : steps)
+    {
+        auto beginTime = chrono::steady_clock::now();
+
+        if (levelSet)
+            FilterLevelSet(grid, step);
+        else
+            FilterOccupancy(grid, step);
+
+        if (nullptr != reports)
+        {
+            VolumeStepReport report;
+            report.step = step;
+            report.miliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - beginTime).count();
+            report.memoryBytes = grid.memUsage();
+            report.activeVoxels = grid.activeVoxelCount();
+            reports->push_back(report);
+        }
+    }
+}
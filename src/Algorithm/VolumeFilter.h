@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Common.h>
+
+#include <openvdb/openvdb.h>
+
+enum class VolumeOperation
+{
+    Dilate = 0,
+    Erode,
+    Gaussian,
+    Mean,
+    Median,
+    Renormalize,
+    Count
+};
+
+struct VolumeStep
+{
+    VolumeOperation operation = VolumeOperation::Gaussian;
+    // Voxels to dilate or erode by, or the filter radius in voxels
+    int width = 1;
+    int iterations = 1;
+};
+
+struct VolumeStepReport
+{
+    VolumeStep step;
+    double miliseconds = 0.0;
+    // Grid memory and active voxels after the step
+    openvdb::Index64 memoryBytes = 0;
+    openvdb::Index64 activeVoxels = 0;
+};
+
+const char* GetVolumeOperationName(VolumeOperation operation);
+// Comma separated steps of name[:width[:iterations]] such as "dilate:1,gaussian:1:2,erode:1", false on an unknown name
+bool ParseVolumeSteps(const string& text, vector<VolumeStep>& steps);
+
+// Runs the steps in order on the grid in place, with OpenVDB's threaded tools.
+// Level sets are offset, filtered and renormalized by LevelSetFilter, which keeps them signed distance fields.
+// Other grids are treated as occupancy: dilate and erode change the active voxels, with new voxels set to 1,
+// the smoothing filters only rewrite active voxels, and renormalize leaves them alone.
+void FilterVolume(openvdb::FloatGrid& grid, const vector<VolumeStep>& steps, vector<VolumeStepReport>* reports = nullptr);
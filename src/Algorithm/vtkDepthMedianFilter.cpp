@@ -0,0 +1,134 @@
+#include <Algorithm/vtkDepthMedianFilter.h>
+#include <Algorithm/vtkQuantizingFilter.h>
+
+vtkStandardNewMacro(vtkDepthMedianFilter);
+
+namespace
+{
+    // Branchless compare-exchange, compiles to minss/maxss
+    inline void Sort2(float& a, float& b)
+    {
+        auto lo = std::min(a, b);
+        auto hi = std::max(a, b);
+        a = lo;
+        b = hi;
+    }
+
+    // Median of 9 with the 19 exchange network from Paeth, "Median finding on a 3x3 grid"
+    inline float Median9(float* p)
+    {
+        Sort2(p[1], p[2]); Sort2(p[4], p[5]); Sort2(p[7], p[8]);
+        Sort2(p[0], p[1]); Sort2(p[3], p[4]); Sort2(p[6], p[7]);
+        Sort2(p[1], p[2]); Sort2(p[4], p[5]); Sort2(p[7], p[8]);
+        Sort2(p[0], p[3]); Sort2(p[5], p[8]); Sort2(p[4], p[7]);
+        Sort2(p[3], p[6]); Sort2(p[1], p[4]); Sort2(p[2], p[5]);
+        Sort2(p[4], p[7]); Sort2(p[4], p[2]); Sort2(p[6], p[4]);
+        Sort2(p[4], p[2]);
+        return p[4];
+    }
+}
+
+void vtkDepthMedianFilter::FilterDepths(const float* depths, float* filtered,
+    unsigned int imageWidth, unsigned int imageHeight, int kernelSize, float emptyDepth)
+{
+    int radius = kernelSize / 2;
+    int width = (int)imageWidth;
+    int height = (int)imageHeight;
+
+    vtkSMPTools::For(0, height, [&](vtkIdType begin, vtkIdType end)
+        {
+            float window[49];
+
+            for (int h = (int)begin; h < (int)end; h++)
+            {
+                for (int w = 0; w < width; w++)
+                {
+                    auto index = (size_t)h * width + w;
+                    if (emptyDepth == depths[index])
+                    {
+                        filtered[index] = emptyDepth;
+                        continue;
+                    }
+
+                    int count = 0;
+                    for (int y = std::max(0, h - radius); y <= std::min(height - 1, h + radius); y++)
+                    {
+                        auto row = depths + (size_t)y * width;
+                        for (int x = std::max(0, w - radius); x <= std::min(width - 1, w + radius); x++)
+                        {
+                            auto d = row[x];
+                            if (emptyDepth != d)
+                            {
+                                window[count++] = d;
+                            }
+                        }
+                    }
+
+                    if (9 == count && 3 == kernelSize)
+                    {
+                        filtered[index] = Median9(window);
+                    }
+                    else
+                    {
+                        auto median = window + count / 2;
+                        std::nth_element(window, median, window + count);
+                        filtered[index] = *median;
+                    }
+                }
+            }
+        });
+}
+
+int vtkDepthMedianFilter::RequestData(vtkInformation* request,
+    vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector)
+{
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+    vtkPolyData* input = vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData* output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    output->ShallowCopy(input);
+
+    unsigned int imageWidth = 0;
+    unsigned int imageHeight = 0;
+    if (false == vtkQuantizingFilter::GetGridDimensions(input, imageWidth, imageHeight))
+    {
+        vtkErrorMacro("Input is not an organized grid, GridDimensions field data is missing");
+        return 0;
+    }
+
+    auto nop = input->GetNumberOfPoints();
+
+    auto inPoints = input->GetPoints();
+    vtkNew<vtkPoints> newPoints;
+    newPoints->SetDataTypeToFloat();
+    newPoints->SetNumberOfPoints(nop);
+    auto xyz = vtkFloatArray::FastDownCast(newPoints->GetData())->GetPointer(0);
+
+    std::vector<float> depths(nop);
+    std::vector<float> filtered(nop);
+    vtkSMPTools::For(0, nop, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                double p[3];
+                inPoints->GetPoint(i, p);
+                xyz[i * 3 + 0] = (float)p[0];
+                xyz[i * 3 + 1] = (float)p[1];
+                depths[i] = (float)p[2];
+            }
+        });
+
+    FilterDepths(depths.data(), filtered.data(), imageWidth, imageHeight, kernelSize, emptyDepth);
+
+    vtkSMPTools::For(0, nop, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++) xyz[i * 3 + 2] = filtered[i];
+        });
+
+    output->SetPoints(newPoints);
+
+    return 1;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Common.h>
+
+// Median filter over the depth of an organized grid such as the vtkQuantizingFilter output.
+// Works in image space with a square window, empty cells are neither filtered nor used as samples.
+class vtkDepthMedianFilter : public vtkPolyDataAlgorithm
+{
+public:
+    static vtkDepthMedianFilter* New();
+    vtkTypeMacro(vtkDepthMedianFilter, vtkPolyDataAlgorithm);
+
+    // 3, 5 or 7
+    int GetKernelSize() const { return kernelSize; }
+    void SetKernelSize(int size) { kernelSize = std::clamp(size | 1, 3, 7); Modified(); }
+    float GetEmptyDepth() const { return emptyDepth; }
+    void SetEmptyDepth(float depth) { emptyDepth = depth; Modified(); }
+
+    static void FilterDepths(const float* depths, float* filtered,
+        unsigned int imageWidth, unsigned int imageHeight, int kernelSize, float emptyDepth);
+
+protected:
+    vtkDepthMedianFilter() {}
+    ~vtkDepthMedianFilter() override {}
+
+    int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
+    int kernelSize = 3;
+    float emptyDepth = -1000.0f;
+};
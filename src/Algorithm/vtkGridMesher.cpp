@@ -0,0 +1,241 @@
+#include <Algorithm/vtkGridMesher.h>
+#include <Algorithm/vtkQuantizingFilter.h>
+
+vtkStandardNewMacro(vtkGridMesher);
+
+namespace
+{
+    // How a quad is split, the corners are 0 (w, h), 1 (w + 1, h), 2 (w, h + 1) and 3 (w + 1, h + 1)
+    enum QuadSplit : unsigned char
+    {
+        SplitNone = 0,
+        // 0-3 diagonal
+        SplitMain,
+        // 1-2 diagonal
+        SplitAnti,
+        // A single triangle, the rest of the quad is dropped
+        Split013,
+        Split032,
+        Split012,
+        Split132
+    };
+
+    const int SplitTriangles[7][2][3] = {
+        { { 0, 0, 0 }, { 0, 0, 0 } },
+        { { 0, 1, 3 }, { 0, 3, 2 } },
+        { { 0, 1, 2 }, { 1, 3, 2 } },
+        { { 0, 1, 3 }, { 0, 0, 0 } },
+        { { 0, 3, 2 }, { 0, 0, 0 } },
+        { { 0, 1, 2 }, { 0, 0, 0 } },
+        { { 1, 3, 2 }, { 0, 0, 0 } } };
+
+    inline int NumberOfTriangles(unsigned char split)
+    {
+        return SplitNone == split ? 0 : (SplitMain == split || SplitAnti == split ? 2 : 1);
+    }
+
+    inline float Distance2(const float* a, const float* b)
+    {
+        auto dx = a[0] - b[0];
+        auto dy = a[1] - b[1];
+        auto dz = a[2] - b[2];
+        return dx * dx + dy * dy + dz * dz;
+    }
+}
+
+vtkSmartPointer<vtkCellArray> vtkGridMesher::MeshGrid(const float* xyz,
+    unsigned int imageWidth, unsigned int imageHeight, float maxEdgeLength, float emptyDepth)
+{
+    auto polys = vtkSmartPointer<vtkCellArray>::New();
+    if (imageWidth < 2 || imageHeight < 2)
+        return polys;
+
+    auto quadsPerRow = (size_t)imageWidth - 1;
+    auto numberOfRows = (vtkIdType)imageHeight - 1;
+    auto maxEdgeLength2 = maxEdgeLength * maxEdgeLength;
+
+    vector<unsigned char> splits(quadsPerRow * numberOfRows);
+    vector<vtkIdType> rowTriangles(numberOfRows + 1, 0);
+    vtkSMPTools::For(0, numberOfRows, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType h = begin; h < end; h++)
+            {
+                vtkIdType count = 0;
+                for (size_t w = 0; w < quadsPerRow; w++)
+                {
+                    size_t corners[4] = {
+                        (size_t)h * imageWidth + w, (size_t)h * imageWidth + w + 1,
+                        (size_t)(h + 1) * imageWidth + w, (size_t)(h + 1) * imageWidth + w + 1 };
+
+                    bool valid[4];
+                    for (int c = 0; c < 4; c++)
+                    {
+                        auto z = xyz[corners[c] * 3 + 2];
+                        valid[c] = emptyDepth != z && std::abs(z) < FLT_MAX;
+                    }
+
+                    auto edge = [&](int a, int b)
+                        {
+                            return valid[a] && valid[b]
+                                && Distance2(xyz + corners[a] * 3, xyz + corners[b] * 3) <= maxEdgeLength2;
+                        };
+                    bool e01 = edge(0, 1), e02 = edge(0, 2), e13 = edge(1, 3), e23 = edge(2, 3);
+                    bool e03 = edge(0, 3), e12 = edge(1, 2);
+
+                    bool t013 = e01 && e13 && e03;
+                    bool t032 = e03 && e23 && e02;
+                    bool t012 = e01 && e12 && e02;
+                    bool t132 = e13 && e23 && e12;
+
+                    unsigned char split = SplitNone;
+                    if (t013 && t032) split = SplitMain;
+                    else if (t012 && t132) split = SplitAnti;
+                    else if (t013) split = Split013;
+                    else if (t032) split = Split032;
+                    else if (t012) split = Split012;
+                    else if (t132) split = Split132;
+
+                    splits[h * quadsPerRow + w] = split;
+                    count += NumberOfTriangles(split);
+                }
+                rowTriangles[h + 1] = count;
+            }
+        });
+
+    for (vtkIdType h = 0; h < numberOfRows; h++)
+    {
+        rowTriangles[h + 1] += rowTriangles[h];
+    }
+
+    auto numberOfTriangles = rowTriangles[numberOfRows];
+    vtkNew<vtkIdTypeArray> offsets;
+    offsets->SetNumberOfTuples(numberOfTriangles + 1);
+    auto offsetPointer = offsets->GetPointer(0);
+    vtkNew<vtkIdTypeArray> connectivity;
+    connectivity->SetNumberOfTuples(numberOfTriangles * 3);
+    auto connectivityPointer = connectivity->GetPointer(0);
+    offsetPointer[numberOfTriangles] = numberOfTriangles * 3;
+
+    vtkSMPTools::For(0, numberOfRows, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType h = begin; h < end; h++)
+            {
+                auto triangle = rowTriangles[h];
+                for (size_t w = 0; w < quadsPerRow; w++)
+                {
+                    auto split = splits[h * quadsPerRow + w];
+                    vtkIdType corners[4] = {
+                        h * imageWidth + (vtkIdType)w, h * imageWidth + (vtkIdType)w + 1,
+                        (h + 1) * imageWidth + (vtkIdType)w, (h + 1) * imageWidth + (vtkIdType)w + 1 };
+
+                    for (int t = 0; t < NumberOfTriangles(split); t++)
+                    {
+                        offsetPointer[triangle] = triangle * 3;
+                        for (int c = 0; c < 3; c++)
+                        {
+                            connectivityPointer[triangle * 3 + c] = corners[SplitTriangles[split][t][c]];
+                        }
+                        triangle++;
+                    }
+                }
+            }
+        });
+
+    polys->SetData(offsets, connectivity);
+    return polys;
+}
+
+int vtkGridMesher::RequestData(vtkInformation* request,
+    vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector)
+{
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+    vtkPolyData* input = vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData* output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    output->ShallowCopy(input);
+
+    unsigned int imageWidth = 0;
+    unsigned int imageHeight = 0;
+    if (false == vtkQuantizingFilter::GetGridDimensions(input, imageWidth, imageHeight))
+    {
+        vtkErrorMacro("Input is not an organized grid, GridDimensions field data is missing");
+        return 0;
+    }
+
+    // Float points are meshed in place, others through a float copy
+    auto inPoints = input->GetPoints();
+    const float* xyz = nullptr;
+    std::vector<float> storage;
+    if (auto floatArray = vtkFloatArray::FastDownCast(inPoints->GetData()))
+    {
+        xyz = floatArray->GetPointer(0);
+    }
+    else
+    {
+        auto nop = input->GetNumberOfPoints();
+        storage.resize((size_t)nop * 3);
+        vtkSMPTools::For(0, nop, [&](vtkIdType begin, vtkIdType end)
+            {
+                for (vtkIdType i = begin; i < end; i++)
+                {
+                    double p[3];
+                    inPoints->GetPoint(i, p);
+                    for (int axis = 0; axis < 3; axis++) storage[i * 3 + axis] = (float)p[axis];
+                }
+            });
+        xyz = storage.data();
+    }
+
+    auto polys = MeshGrid(xyz, imageWidth, imageHeight, maxEdgeLength, emptyDepth);
+    if (false == compact)
+    {
+        output->SetPolys(polys);
+        return 1;
+    }
+
+    // Used points keep their order, the new ids are the prefix sums of the used flags
+    auto nop = input->GetNumberOfPoints();
+    // MeshGrid fills vtkIdType arrays, so the storage behind the cell array holds vtkIdType as well
+    auto connectivity = polys->GetConnectivityArray();
+    auto connectivityPointer = static_cast<vtkIdType*>(connectivity->GetVoidPointer(0));
+    auto numberOfIndices = connectivity->GetNumberOfTuples();
+
+    // Triangles share corners, so the used points are marked in one serial pass instead of racing on the same slots
+    vector<vtkIdType> pointMap(nop + 1, 0);
+    for (vtkIdType i = 0; i < numberOfIndices; i++)
+    {
+        pointMap[connectivityPointer[i] + 1] = 1;
+    }
+    for (vtkIdType i = 0; i < nop; i++)
+    {
+        pointMap[i + 1] += pointMap[i];
+    }
+
+    auto numberOfUsed = pointMap[nop];
+    vtkNew<vtkPoints> newPoints;
+    newPoints->SetDataTypeToFloat();
+    newPoints->SetNumberOfPoints(numberOfUsed);
+    auto newXYZ = vtkFloatArray::FastDownCast(newPoints->GetData())->GetPointer(0);
+    vtkSMPTools::For(0, nop, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                if (pointMap[i] == pointMap[i + 1])
+                    continue;
+                for (int axis = 0; axis < 3; axis++) newXYZ[pointMap[i] * 3 + axis] = xyz[i * 3 + axis];
+            }
+        });
+    vtkSMPTools::For(0, numberOfIndices, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++) connectivityPointer[i] = pointMap[connectivityPointer[i]];
+        });
+
+    output->Initialize();
+    output->SetPoints(newPoints);
+    output->SetPolys(polys);
+
+    return 1;
+}
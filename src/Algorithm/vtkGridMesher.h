@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Common.h>
+
+// Triangulates an organized grid such as the vtkQuantizingFilter output, two triangles per cell quad.
+// Triangles with an empty corner or an edge longer than MaxEdgeLength are dropped, so no triangle spans
+// a depth discontinuity. A quad that fails on one diagonal is split along the other one.
+// The output shares the input points unless Compact is on, only the polys are new.
+class vtkGridMesher : public vtkPolyDataAlgorithm
+{
+public:
+    static vtkGridMesher* New();
+    vtkTypeMacro(vtkGridMesher, vtkPolyDataAlgorithm);
+
+    float GetMaxEdgeLength() const { return maxEdgeLength; }
+    void SetMaxEdgeLength(float length) { maxEdgeLength = length; Modified(); }
+    // Non finite and FLT_MAX depths are always empty
+    float GetEmptyDepth() const { return emptyDepth; }
+    void SetEmptyDepth(float depth) { emptyDepth = depth; Modified(); }
+    // Drops the points no triangle uses, the output then loses the grid layout and its GridDimensions
+    bool GetCompact() const { return compact; }
+    void SetCompact(bool value) { compact = value; Modified(); }
+
+    // Rows are counted in parallel, then written in parallel at their prefix sum offsets.
+    static vtkSmartPointer<vtkCellArray> MeshGrid(const float* xyz,
+        unsigned int imageWidth, unsigned int imageHeight, float maxEdgeLength, float emptyDepth);
+
+protected:
+    vtkGridMesher() {}
+    ~vtkGridMesher() override {}
+
+    int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
+    float maxEdgeLength = 0.2f;
+    float emptyDepth = -1000.0f;
+    bool compact = false;
+};
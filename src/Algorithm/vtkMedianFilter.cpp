@@ -1,63 +1,468 @@
 #include <Algorithm/vtkMedianFilter.h>
+#include <Algorithm/OrganizedPointCloud.h>
 
 vtkStandardNewMacro(vtkMedianFilter);
 
-int vtkMedianFilter::RequestData(vtkInformation* request,
-    vtkInformationVector** inputVector,
-    vtkInformationVector* outputVector)
+namespace
 {
-    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
-    vtkPolyData* input = vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+    // Neighbour queries through the static locator, which is safe to query from several threads
+    struct LocatorNeighbors
+    {
+        vtkStaticPointLocator* locator;
 
-    vtkSmartPointer<vtkKdTreePointLocator> kdTree = vtkSmartPointer<vtkKdTreePointLocator>::New();
-    kdTree->SetDataSet(input);
-    kdTree->BuildLocator();
+        inline bool IsValid(vtkIdType) const { return true; }
 
-    auto points = input->GetPoints();
-    auto nop = input->GetNumberOfPoints();
-    for (size_t i = 0; i < nop; i++)
+        inline void FindPointsWithinRadius(vtkIdType, double radius, const double* point, vtkIdList* result)
+        {
+            locator->FindPointsWithinRadius(radius, point, result);
+        }
+
+        inline void FindClosestNPoints(vtkIdType, int n, const double* point, vtkIdList* result)
+        {
+            locator->FindClosestNPoints(n, point, result);
+        }
+    };
+
+    // Neighbour queries over the cells around a grid cell, empty cells are never returned
+    struct GridNeighbors
     {
-        auto point = points->GetPoint(i);
-        vtkSmartPointer<vtkIdList> result = vtkSmartPointer<vtkIdList>::New();
-        kdTree->FindPointsWithinRadius(0.5f, point, result);
+        const OrganizedPointCloud* cloud;
+        int windowRadius;
+
+        vtkSMPThreadLocal<std::vector<std::pair<double, vtkIdType>>> candidates;
+
+        GridNeighbors(const OrganizedPointCloud* cloud, int windowRadius) : cloud(cloud), windowRadius(windowRadius) {}
+
+        inline bool IsValid(vtkIdType i) const { return cloud->IsValid((size_t)i); }
 
-        std::vector<double> distances;
-        for (vtkIdType j = 0; j < result->GetNumberOfIds(); j++)
+        inline double Distance2(size_t index, const double* point) const
         {
-            vtkIdType neighborId = result->GetId(j);
-            double neighborPoint[3];
-            points->GetPoint(neighborId, neighborPoint);
+            double dx = cloud->GetX()[index] - point[0];
+            double dy = cloud->GetY()[index] - point[1];
+            double dz = cloud->GetZ()[index] - point[2];
+            return dx * dx + dy * dy + dz * dz;
+        }
 
-            double distance = sqrt(vtkMath::Distance2BetweenPoints(point, neighborPoint));
-            distances.push_back(distance);
+        void FindPointsWithinRadius(vtkIdType i, double radius, const double* point, vtkIdList* result)
+        {
+            result->Reset();
+            auto radius2 = radius * radius;
+            for (auto neighbor : cloud->GetNeighborhood((size_t)i, windowRadius))
+            {
+                if (Distance2(neighbor, point) <= radius2)
+                {
+                    result->InsertNextId((vtkIdType)neighbor);
+                }
+            }
         }
 
-        std::sort(distances.begin(), distances.end());
-        double medianDistance = distances[distances.size() / 2];
+        void FindClosestNPoints(vtkIdType i, int n, const double* point, vtkIdList* result)
+        {
+            auto& sorted = candidates.Local();
+            sorted.clear();
+            for (auto neighbor : cloud->GetNeighborhood((size_t)i, windowRadius))
+            {
+                sorted.emplace_back(Distance2(neighbor, point), (vtkIdType)neighbor);
+            }
+
+            auto count = std::min((size_t)n, sorted.size());
+            std::partial_sort(sorted.begin(), sorted.begin() + count, sorted.end());
+
+            result->SetNumberOfIds((vtkIdType)count);
+            for (size_t j = 0; j < count; j++)
+            {
+                result->SetId((vtkIdType)j, sorted[j].second);
+            }
+        }
+    };
+
+    // Median distance from every point to the neighbours within the radius.
+    // Scratch buffers are per thread so the loop body does not allocate once they have grown.
+    template <typename Neighbors>
+    struct MedianDistanceWorker
+    {
+        vtkPoints* points;
+        Neighbors& locator;
+        double radius;
+        float* medianDistances;
+
+        vtkSMPThreadLocalObject<vtkIdList> neighbors;
+        vtkSMPThreadLocal<std::vector<double>> distances;
 
-        //std::cout << "Point ID: " << i << " Median Distance: " << medianDistance << std::endl;
+        MedianDistanceWorker(vtkPoints* points, Neighbors& locator, double radius, float* medianDistances)
+            : points(points), locator(locator), radius(radius), medianDistances(medianDistances) {}
 
-        for (vtkIdType j = 0; j < result->GetNumberOfIds(); j++)
+        void Initialize()
         {
-            vtkIdType neighborId = result->GetId(j);
-            double neighborPoint[3];
-            points->GetPoint(neighborId, neighborPoint);
+            neighbors.Local()->Allocate(128);
+            distances.Local().reserve(128);
+        }
+
+        void operator()(vtkIdType begin, vtkIdType end)
+        {
+            auto result = neighbors.Local();
+            auto& squaredDistances = distances.Local();
+
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                if (false == locator.IsValid(i))
+                {
+                    medianDistances[i] = 0.0f;
+                    continue;
+                }
 
-            double distance = sqrt(vtkMath::Distance2BetweenPoints(point, neighborPoint));
+                double point[3];
+                points->GetPoint(i, point);
+                locator.FindPointsWithinRadius(i, radius, point, result);
 
-            //// If the distance exceeds the median, replace the point's coordinates with the query point's coordinates
-            //if (distance > medianDistance)
-            //{
-            //    points->SetPoint(neighborId, point); // Replace the point exceeding the median
-            //    //std::cout << "Replaced Point ID: " << neighborId << " Exceeds Median Distance." << std::endl;
-            //}
+                auto numberOfNeighbors = result->GetNumberOfIds();
+                if (0 == numberOfNeighbors)
+                {
+                    medianDistances[i] = 0.0f;
+                    continue;
+                }
+
+                squaredDistances.resize(numberOfNeighbors);
+                for (vtkIdType j = 0; j < numberOfNeighbors; j++)
+                {
+                    double neighborPoint[3];
+                    points->GetPoint(result->GetId(j), neighborPoint);
+                    squaredDistances[j] = vtkMath::Distance2BetweenPoints(point, neighborPoint);
+                }
+
+                // sqrt is monotonic, so selecting on squared distances gives the same median
+                auto median = squaredDistances.begin() + numberOfNeighbors / 2;
+                std::nth_element(squaredDistances.begin(), median, squaredDistances.end());
+                medianDistances[i] = (float)sqrt(*median);
+            }
         }
+
+        void Reduce() {}
+    };
+
+    // Mean distance from every point to its k nearest neighbours, the point itself excluded.
+    template <typename Neighbors>
+    struct MeanNeighborDistanceWorker
+    {
+        vtkPoints* points;
+        Neighbors& locator;
+        int numberOfNeighbors;
+        float* meanDistances;
+
+        vtkSMPThreadLocalObject<vtkIdList> neighbors;
+
+        MeanNeighborDistanceWorker(vtkPoints* points, Neighbors& locator, int numberOfNeighbors, float* meanDistances)
+            : points(points), locator(locator), numberOfNeighbors(numberOfNeighbors), meanDistances(meanDistances) {}
+
+        void Initialize()
+        {
+            neighbors.Local()->Allocate(numberOfNeighbors + 1);
+        }
+
+        void operator()(vtkIdType begin, vtkIdType end)
+        {
+            auto result = neighbors.Local();
+
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                if (false == locator.IsValid(i))
+                {
+                    meanDistances[i] = std::numeric_limits<float>::quiet_NaN();
+                    continue;
+                }
+
+                double point[3];
+                points->GetPoint(i, point);
+                locator.FindClosestNPoints(i, numberOfNeighbors + 1, point, result);
+
+                double sum = 0.0;
+                int count = 0;
+                for (vtkIdType j = 0; j < result->GetNumberOfIds(); j++)
+                {
+                    auto neighborId = result->GetId(j);
+                    if (neighborId == i)
+                        continue;
+
+                    double neighborPoint[3];
+                    points->GetPoint(neighborId, neighborPoint);
+                    sum += sqrt(vtkMath::Distance2BetweenPoints(point, neighborPoint));
+                    count++;
+                }
+                meanDistances[i] = 0 < count ? (float)(sum / count) : 0.0f;
+            }
+        }
+
+        void Reduce() {}
+    };
+
+    // Flags points that have at least the minimum number of other points within the radius.
+    template <typename Neighbors>
+    struct RadiusOutlierWorker
+    {
+        vtkPoints* points;
+        Neighbors& locator;
+        double radius;
+        int minimumNumberOfNeighbors;
+        unsigned char* keep;
+
+        vtkSMPThreadLocalObject<vtkIdList> neighbors;
+
+        RadiusOutlierWorker(vtkPoints* points, Neighbors& locator, double radius, int minimumNumberOfNeighbors, unsigned char* keep)
+            : points(points), locator(locator), radius(radius), minimumNumberOfNeighbors(minimumNumberOfNeighbors), keep(keep) {}
+
+        void Initialize()
+        {
+            neighbors.Local()->Allocate(128);
+        }
+
+        void operator()(vtkIdType begin, vtkIdType end)
+        {
+            auto result = neighbors.Local();
+
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                if (false == locator.IsValid(i))
+                {
+                    keep[i] = 0;
+                    continue;
+                }
+
+                double point[3];
+                points->GetPoint(i, point);
+                locator.FindPointsWithinRadius(i, radius, point, result);
+
+                // The query point is always part of the result
+                keep[i] = minimumNumberOfNeighbors <= result->GetNumberOfIds() - 1 ? 1 : 0;
+            }
+        }
+
+        void Reduce() {}
+    };
+
+    // Component-wise median of the neighbour positions within the radius.
+    template <typename Neighbors>
+    struct MedianPositionWorker
+    {
+        vtkPoints* points;
+        Neighbors& locator;
+        double radius;
+        vtkPoints* newPoints;
+
+        vtkSMPThreadLocalObject<vtkIdList> neighbors;
+        vtkSMPThreadLocal<std::vector<double>> coordinates;
+
+        MedianPositionWorker(vtkPoints* points, Neighbors& locator, double radius, vtkPoints* newPoints)
+            : points(points), locator(locator), radius(radius), newPoints(newPoints) {}
+
+        void Initialize()
+        {
+            neighbors.Local()->Allocate(128);
+            coordinates.Local().reserve(3 * 128);
+        }
+
+        void operator()(vtkIdType begin, vtkIdType end)
+        {
+            auto result = neighbors.Local();
+            auto& values = coordinates.Local();
+
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                double point[3];
+                points->GetPoint(i, point);
+                if (false == locator.IsValid(i))
+                {
+                    newPoints->SetPoint(i, point);
+                    continue;
+                }
+
+                locator.FindPointsWithinRadius(i, radius, point, result);
+
+                auto numberOfNeighbors = result->GetNumberOfIds();
+                if (0 < numberOfNeighbors)
+                {
+                    // x values first, then y, then z, so every axis is selected on a contiguous range
+                    values.resize(3 * numberOfNeighbors);
+                    for (vtkIdType j = 0; j < numberOfNeighbors; j++)
+                    {
+                        double neighborPoint[3];
+                        points->GetPoint(result->GetId(j), neighborPoint);
+                        values[j] = neighborPoint[0];
+                        values[numberOfNeighbors + j] = neighborPoint[1];
+                        values[2 * numberOfNeighbors + j] = neighborPoint[2];
+                    }
+
+                    for (int axis = 0; axis < 3; axis++)
+                    {
+                        auto first = values.begin() + axis * numberOfNeighbors;
+                        auto median = first + numberOfNeighbors / 2;
+                        std::nth_element(first, median, first + numberOfNeighbors);
+                        point[axis] = *median;
+                    }
+                }
+
+                newPoints->SetPoint(i, point);
+            }
+        }
+
+        void Reduce() {}
+    };
+
+    // Copies the kept points and their point data into the output, each tuple exactly once.
+    void ExtractPoints(vtkPolyData* input, vtkPolyData* output, const std::vector<unsigned char>& keep)
+    {
+        auto nop = input->GetNumberOfPoints();
+
+        std::vector<vtkIdType> pointMap(nop);
+        vtkIdType numberOfOutputPoints = 0;
+        for (vtkIdType i = 0; i < nop; i++)
+        {
+            pointMap[i] = keep[i] ? numberOfOutputPoints++ : -1;
+        }
+
+        auto inPoints = input->GetPoints();
+        vtkNew<vtkPoints> newPoints;
+        newPoints->SetDataType(inPoints->GetDataType());
+        newPoints->SetNumberOfPoints(numberOfOutputPoints);
+
+        auto inPD = input->GetPointData();
+        auto outPD = output->GetPointData();
+        outPD->CopyAllocate(inPD, numberOfOutputPoints);
+        ArrayList arrays;
+        arrays.AddArrays(numberOfOutputPoints, inPD, outPD);
+
+        vtkSMPTools::For(0, nop, [&](vtkIdType begin, vtkIdType end)
+            {
+                for (vtkIdType i = begin; i < end; i++)
+                {
+                    auto outId = pointMap[i];
+                    if (outId < 0)
+                        continue;
+
+                    double point[3];
+                    inPoints->GetPoint(i, point);
+                    newPoints->SetPoint(outId, point);
+                    arrays.Copy(i, outId);
+                }
+            });
+
+        output->SetPoints(newPoints);
     }
+}
+
+int vtkMedianFilter::RequestData(vtkInformation* request,
+    vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector)
+{
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+    vtkPolyData* input = vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
 
     vtkInformation* outInfo = outputVector->GetInformationObject(0);
     vtkPolyData* output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-    output->ShallowCopy(input);
+    if (0 == input->GetNumberOfPoints())
+    {
+        output->ShallowCopy(input);
+        return 1;
+    }
+
+    // Organized grids already know their neighbours, no index is built for them
+    OrganizedPointCloud cloud;
+    if (useGridNeighborhood && OrganizedPointCloud::FromPolyData(input, cloud, emptyDepth))
+    {
+        GridNeighbors neighbors(&cloud, gridWindowRadius);
+        Execute(input, output, neighbors);
+    }
+    else
+    {
+        vtkNew<vtkStaticPointLocator> locator;
+        locator->SetDataSet(input);
+        locator->BuildLocator();
+
+        LocatorNeighbors neighbors{ locator };
+        Execute(input, output, neighbors);
+    }
 
     return 1;
 }
+
+template <typename Neighbors>
+void vtkMedianFilter::Execute(vtkPolyData* input, vtkPolyData* output, Neighbors& locator)
+{
+    auto nop = input->GetNumberOfPoints();
+    auto points = input->GetPoints();
+
+    if (MEDIAN_DISTANCE == mode)
+    {
+        output->ShallowCopy(input);
+
+        vtkNew<vtkFloatArray> medianDistances;
+        medianDistances->SetName("MedianDistance");
+        medianDistances->SetNumberOfComponents(1);
+        medianDistances->SetNumberOfTuples(nop);
+
+        MedianDistanceWorker<Neighbors> worker(points, locator, radius, medianDistances->GetPointer(0));
+        vtkSMPTools::For(0, nop, worker);
+
+        output->GetPointData()->AddArray(medianDistances);
+    }
+    else if (STATISTICAL_OUTLIER_REMOVAL == mode)
+    {
+        std::vector<float> meanDistances(nop);
+        MeanNeighborDistanceWorker<Neighbors> worker(points, locator, numberOfNeighbors, meanDistances.data());
+        vtkSMPTools::For(0, nop, worker);
+
+        // Empty grid cells carry NaN and stay out of the statistics
+        double mean = 0.0;
+        size_t count = 0;
+        for (auto d : meanDistances)
+        {
+            if (std::isnan(d)) continue;
+            mean += d;
+            count++;
+        }
+        mean /= (double)std::max((size_t)1, count);
+
+        double variance = 0.0;
+        for (auto d : meanDistances)
+        {
+            if (std::isnan(d)) continue;
+            variance += (d - mean) * (d - mean);
+        }
+        variance /= (double)std::max((size_t)1, count);
+
+        auto threshold = mean + standardDeviationFactor * sqrt(variance);
+
+        std::vector<unsigned char> keep(nop);
+        vtkSMPTools::For(0, nop, [&](vtkIdType begin, vtkIdType end)
+            {
+                for (vtkIdType i = begin; i < end; i++)
+                {
+                    // false for NaN
+                    keep[i] = meanDistances[i] <= threshold ? 1 : 0;
+                }
+            });
+
+        ExtractPoints(input, output, keep);
+    }
+    else if (RADIUS_OUTLIER_REMOVAL == mode)
+    {
+        std::vector<unsigned char> keep(nop);
+        RadiusOutlierWorker<Neighbors> worker(points, locator, radius, minimumNumberOfNeighbors, keep.data());
+        vtkSMPTools::For(0, nop, worker);
+
+        ExtractPoints(input, output, keep);
+    }
+    else if (MEDIAN_SMOOTHING == mode)
+    {
+        vtkNew<vtkPoints> newPoints;
+        newPoints->SetDataType(points->GetDataType());
+        newPoints->SetNumberOfPoints(nop);
+
+        MedianPositionWorker<Neighbors> worker(points, locator, radius, newPoints);
+        vtkSMPTools::For(0, nop, worker);
+
+        // Point data is shared with the input, only the positions change
+        output->ShallowCopy(input);
+        output->SetPoints(newPoints);
+    }
+}
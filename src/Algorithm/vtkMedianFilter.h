@@ -6,11 +6,55 @@ class vtkMedianFilter : public vtkPolyDataAlgorithm
 {
 public:
     static vtkMedianFilter* New();
-    vtkMedianFilter(vtkMedianFilter, vtkPolyDataAlgorithm);
+    vtkTypeMacro(vtkMedianFilter, vtkPolyDataAlgorithm);
+
+    enum Mode
+    {
+        // Passes the points through and adds a MedianDistance point array
+        MEDIAN_DISTANCE = 0,
+        // Removes points whose mean distance to their k nearest neighbours exceeds mean + factor * stddev
+        STATISTICAL_OUTLIER_REMOVAL,
+        // Removes points with fewer than the minimum number of neighbours within the radius
+        RADIUS_OUTLIER_REMOVAL,
+        // Moves every point to the component-wise median of its neighbours within the radius
+        MEDIAN_SMOOTHING,
+    };
+
+    Mode GetMode() const { return mode; }
+    void SetMode(Mode m) { mode = m; Modified(); }
+    double GetRadius() const { return radius; }
+    void SetRadius(double r) { radius = r; Modified(); }
+    int GetNumberOfNeighbors() const { return numberOfNeighbors; }
+    void SetNumberOfNeighbors(int n) { numberOfNeighbors = n; Modified(); }
+    double GetStandardDeviationFactor() const { return standardDeviationFactor; }
+    void SetStandardDeviationFactor(double factor) { standardDeviationFactor = factor; Modified(); }
+    int GetMinimumNumberOfNeighbors() const { return minimumNumberOfNeighbors; }
+    void SetMinimumNumberOfNeighbors(int n) { minimumNumberOfNeighbors = n; Modified(); }
+
+    // Inputs with GridDimensions field data take their neighbours from the grid window instead of a locator,
+    // the window then also bounds the radius and k nearest neighbour searches
+    bool GetUseGridNeighborhood() const { return useGridNeighborhood; }
+    void SetUseGridNeighborhood(bool use) { useGridNeighborhood = use; Modified(); }
+    int GetGridWindowRadius() const { return gridWindowRadius; }
+    void SetGridWindowRadius(int r) { gridWindowRadius = r; Modified(); }
+    float GetEmptyDepth() const { return emptyDepth; }
+    void SetEmptyDepth(float depth) { emptyDepth = depth; Modified(); }
 
 protected:
     vtkMedianFilter() {}
     ~vtkMedianFilter() override {}
 
     int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
+    template <typename Neighbors>
+    void Execute(vtkPolyData* input, vtkPolyData* output, Neighbors& neighbors);
+
+    Mode mode = MEDIAN_DISTANCE;
+    double radius = 0.5;
+    int numberOfNeighbors = 8;
+    double standardDeviationFactor = 1.0;
+    int minimumNumberOfNeighbors = 4;
+    bool useGridNeighborhood = true;
+    int gridWindowRadius = 2;
+    float emptyDepth = -1000.0f;
 };
@@ -0,0 +1,205 @@
+#include <Algorithm/vtkNormalEstimationFilter.h>
+#include <Algorithm/OrganizedPointCloud.h>
+
+#include <Eigen/Dense>
+
+vtkStandardNewMacro(vtkNormalEstimationFilter);
+
+namespace
+{
+    // k nearest neighbours through the static locator, which is safe to query from several threads
+    struct LocatorNeighbors
+    {
+        vtkStaticPointLocator* locator;
+
+        inline bool IsValid(vtkIdType) const { return true; }
+
+        inline void FindClosestNPoints(vtkIdType, int n, const double* point, vtkIdList* result)
+        {
+            locator->FindClosestNPoints(n, point, result);
+        }
+    };
+
+    // k nearest neighbours among the valid cells of the window around a grid cell, in no particular order
+    struct GridNeighbors
+    {
+        const OrganizedPointCloud* cloud;
+        int windowRadius;
+
+        vtkSMPThreadLocal<std::vector<std::pair<double, vtkIdType>>> candidates;
+
+        GridNeighbors(const OrganizedPointCloud* cloud, int windowRadius) : cloud(cloud), windowRadius(windowRadius) {}
+
+        inline bool IsValid(vtkIdType i) const { return cloud->IsValid((size_t)i); }
+
+        void FindClosestNPoints(vtkIdType i, int n, const double* point, vtkIdList* result)
+        {
+            auto& window = candidates.Local();
+            window.clear();
+            for (auto neighbor : cloud->GetNeighborhood((size_t)i, windowRadius))
+            {
+                double dx = cloud->GetX()[neighbor] - point[0];
+                double dy = cloud->GetY()[neighbor] - point[1];
+                double dz = cloud->GetZ()[neighbor] - point[2];
+                window.emplace_back(dx * dx + dy * dy + dz * dz, (vtkIdType)neighbor);
+            }
+
+            // The covariance does not care about the order, selecting the k closest is enough
+            auto count = std::min((size_t)n, window.size());
+            if (count < window.size())
+            {
+                std::nth_element(window.begin(), window.begin() + count, window.end());
+            }
+
+            result->SetNumberOfIds((vtkIdType)count);
+            for (size_t j = 0; j < count; j++)
+            {
+                result->SetId((vtkIdType)j, window[j].second);
+            }
+        }
+    };
+
+    // Smallest eigenvector of the neighbourhood covariance per point, flipped to face the scanner.
+    // Offsets are taken from the point itself so the sums stay small and the one pass covariance stays exact.
+    template <typename Neighbors>
+    struct NormalWorker
+    {
+        const float* xyz;
+        Neighbors& locator;
+        int numberOfNeighbors;
+        bool orthographic;
+        Eigen::Vector3d viewPoint;
+        Eigen::Vector3d viewDirection;
+        float* normals;
+
+        vtkSMPThreadLocalObject<vtkIdList> neighbors;
+
+        NormalWorker(const float* xyz, Neighbors& locator, int numberOfNeighbors, bool orthographic,
+            const double* viewPoint, const double* viewDirection, float* normals)
+            : xyz(xyz), locator(locator), numberOfNeighbors(numberOfNeighbors), orthographic(orthographic),
+            viewPoint(viewPoint[0], viewPoint[1], viewPoint[2]), viewDirection(viewDirection[0], viewDirection[1], viewDirection[2]),
+            normals(normals) {}
+
+        void Initialize()
+        {
+            neighbors.Local()->Allocate(numberOfNeighbors);
+        }
+
+        void operator()(vtkIdType begin, vtkIdType end)
+        {
+            auto result = neighbors.Local();
+            Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver;
+
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                auto normal = normals + i * 3;
+                normal[0] = normal[1] = normal[2] = 0.0f;
+                if (false == locator.IsValid(i))
+                    continue;
+
+                double point[3] = { xyz[i * 3], xyz[i * 3 + 1], xyz[i * 3 + 2] };
+                locator.FindClosestNPoints(i, numberOfNeighbors, point, result);
+
+                auto count = result->GetNumberOfIds();
+                if (count < 3)
+                    continue;
+
+                Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+                Eigen::Matrix3d sum2 = Eigen::Matrix3d::Zero();
+                for (vtkIdType j = 0; j < count; j++)
+                {
+                    auto neighbor = xyz + result->GetId(j) * 3;
+                    Eigen::Vector3d d(neighbor[0] - point[0], neighbor[1] - point[1], neighbor[2] - point[2]);
+                    sum += d;
+                    sum2.noalias() += d * d.transpose();
+                }
+                Eigen::Vector3d mean = sum / (double)count;
+                Eigen::Matrix3d covariance = sum2 / (double)count - mean * mean.transpose();
+
+                // Closed form 3x3 solve, eigenvalues come out in increasing order
+                solver.computeDirect(covariance);
+                Eigen::Vector3d n = solver.eigenvectors().col(0);
+
+                Eigen::Vector3d toward = orthographic ? Eigen::Vector3d(-viewDirection) : Eigen::Vector3d(viewPoint - Eigen::Vector3d(point[0], point[1], point[2]));
+                if (n.dot(toward) < 0.0) n = -n;
+
+                normal[0] = (float)n[0];
+                normal[1] = (float)n[1];
+                normal[2] = (float)n[2];
+            }
+        }
+
+        void Reduce() {}
+    };
+}
+
+int vtkNormalEstimationFilter::RequestData(vtkInformation* request,
+    vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector)
+{
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+    vtkPolyData* input = vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData* output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    output->ShallowCopy(input);
+
+    auto nop = input->GetNumberOfPoints();
+    if (0 == nop)
+        return 1;
+
+    // Float points are read in place, anything else is converted once
+    auto points = input->GetPoints();
+    vector<float> converted;
+    const float* xyz = nullptr;
+    auto floatPoints = vtkFloatArray::FastDownCast(points->GetData());
+    if (nullptr != floatPoints)
+    {
+        xyz = floatPoints->GetPointer(0);
+    }
+    else
+    {
+        converted.resize((size_t)nop * 3);
+        vtkSMPTools::For(0, nop, [&](vtkIdType begin, vtkIdType end)
+            {
+                for (vtkIdType i = begin; i < end; i++)
+                {
+                    double p[3];
+                    points->GetPoint(i, p);
+                    converted[i * 3 + 0] = (float)p[0];
+                    converted[i * 3 + 1] = (float)p[1];
+                    converted[i * 3 + 2] = (float)p[2];
+                }
+            });
+        xyz = converted.data();
+    }
+
+    vtkNew<vtkFloatArray> normals;
+    normals->SetName("Normals");
+    normals->SetNumberOfComponents(3);
+    normals->SetNumberOfTuples(nop);
+
+    // Organized grids already know their neighbours, no index is built for them
+    OrganizedPointCloud cloud;
+    if (useGridNeighborhood && OrganizedPointCloud::FromPolyData(input, cloud, emptyDepth))
+    {
+        GridNeighbors neighbors(&cloud, gridWindowRadius);
+        NormalWorker<GridNeighbors> worker(xyz, neighbors, numberOfNeighbors, true, viewPoint, viewDirection, normals->GetPointer(0));
+        vtkSMPTools::For(0, nop, worker);
+    }
+    else
+    {
+        vtkNew<vtkStaticPointLocator> locator;
+        locator->SetDataSet(input);
+        locator->BuildLocator();
+
+        LocatorNeighbors neighbors{ locator };
+        NormalWorker<LocatorNeighbors> worker(xyz, neighbors, numberOfNeighbors, false, viewPoint, viewDirection, normals->GetPointer(0));
+        vtkSMPTools::For(0, nop, worker);
+    }
+
+    output->GetPointData()->SetNormals(normals);
+
+    return 1;
+}
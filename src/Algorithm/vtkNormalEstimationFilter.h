@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Common.h>
+
+// Adds Normals point data from the smallest eigenvector of the covariance of every point's k nearest neighbours.
+// Inputs with GridDimensions field data search the grid window around each cell, other inputs a static locator.
+// Normals face the scanner: organized grids are orthographic depth images seen along ViewDirection,
+// the normals of other inputs point toward ViewPoint. Points with fewer than three neighbours get a zero normal.
+class vtkNormalEstimationFilter : public vtkPolyDataAlgorithm
+{
+public:
+    static vtkNormalEstimationFilter* New();
+    vtkTypeMacro(vtkNormalEstimationFilter, vtkPolyDataAlgorithm);
+
+    int GetNumberOfNeighbors() const { return numberOfNeighbors; }
+    void SetNumberOfNeighbors(int n) { numberOfNeighbors = std::max(3, n); Modified(); }
+
+    bool GetUseGridNeighborhood() const { return useGridNeighborhood; }
+    void SetUseGridNeighborhood(bool use) { useGridNeighborhood = use; Modified(); }
+    int GetGridWindowRadius() const { return gridWindowRadius; }
+    void SetGridWindowRadius(int r) { gridWindowRadius = r; Modified(); }
+    float GetEmptyDepth() const { return emptyDepth; }
+    void SetEmptyDepth(float depth) { emptyDepth = depth; Modified(); }
+
+    const double* GetViewPoint() const { return viewPoint; }
+    void SetViewPoint(double x, double y, double z) { viewPoint[0] = x; viewPoint[1] = y; viewPoint[2] = z; Modified(); }
+    const double* GetViewDirection() const { return viewDirection; }
+    void SetViewDirection(double x, double y, double z) { viewDirection[0] = x; viewDirection[1] = y; viewDirection[2] = z; Modified(); }
+
+protected:
+    vtkNormalEstimationFilter() {}
+    ~vtkNormalEstimationFilter() override {}
+
+    int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
+    int numberOfNeighbors = 16;
+    bool useGridNeighborhood = true;
+    int gridWindowRadius = 2;
+    float emptyDepth = -1000.0f;
+    double viewPoint[3] = { 0.0, 0.0, 0.0 };
+    // Depth grows along +z, so the scanner looks down the z axis
+    double viewDirection[3] = { 0.0, 0.0, 1.0 };
+};
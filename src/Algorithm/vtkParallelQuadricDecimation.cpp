@@ -0,0 +1,559 @@
+#include <Algorithm/vtkParallelQuadricDecimation.h>
+#include <Algorithm/Morton.h>
+
+#include <functional>
+#include <queue>
+
+vtkStandardNewMacro(vtkParallelQuadricDecimation);
+
+namespace
+{
+    // Symmetric 4x4 error quadric, the upper triangle row by row
+    struct Quadric
+    {
+        double q[10] = {};
+
+        static Quadric FromPlane(const double* n, double d, double weight)
+        {
+            double p[4] = { n[0], n[1], n[2], d };
+            Quadric quadric;
+            int k = 0;
+            for (int i = 0; i < 4; i++)
+                for (int j = i; j < 4; j++)
+                    quadric.q[k++] = weight * p[i] * p[j];
+            return quadric;
+        }
+
+        inline void Add(const Quadric& other)
+        {
+            for (int i = 0; i < 10; i++) q[i] += other.q[i];
+        }
+
+        inline double Evaluate(const double* x) const
+        {
+            return q[0] * x[0] * x[0] + 2.0 * q[1] * x[0] * x[1] + 2.0 * q[2] * x[0] * x[2] + 2.0 * q[3] * x[0]
+                + q[4] * x[1] * x[1] + 2.0 * q[5] * x[1] * x[2] + 2.0 * q[6] * x[1]
+                + q[7] * x[2] * x[2] + 2.0 * q[8] * x[2] + q[9];
+        }
+
+        // Point of least error, false when the quadric is too flat to have one
+        bool Minimize(double* x) const
+        {
+            double a[3][3] = { { q[0], q[1], q[2] }, { q[1], q[4], q[5] }, { q[2], q[5], q[7] } };
+            double b[3] = { -q[3], -q[6], -q[8] };
+            auto det = vtkMath::Determinant3x3(a);
+            auto trace = q[0] + q[4] + q[7];
+            if (false == (std::abs(det) > 1e-10 * trace * trace * trace))
+                return false;
+
+            for (int axis = 0; axis < 3; axis++)
+            {
+                double m[3][3];
+                for (int r = 0; r < 3; r++)
+                    for (int c = 0; c < 3; c++)
+                        m[r][c] = c == axis ? b[r] : a[r][c];
+                x[axis] = vtkMath::Determinant3x3(m) / det;
+            }
+            return true;
+        }
+    };
+
+    struct Candidate
+    {
+        double cost;
+        vtkIdType u;
+        vtkIdType v;
+        uint32_t uVersion;
+        uint32_t vVersion;
+        double x[3];
+
+        inline bool operator>(const Candidate& other) const { return cost > other.cost; }
+    };
+
+    class Decimator
+    {
+    public:
+        vector<double> xyz;
+        vector<vtkIdType> triangles;
+        vector<unsigned char> aliveTriangle;
+        vector<vector<vtkIdType>> vertexTriangles;
+        vector<Quadric> quadrics;
+        vector<unsigned char> locked;
+        vector<unsigned char> collapsed;
+        vector<uint32_t> versions;
+
+        inline vtkIdType NumberOfVertices() const { return (vtkIdType)locked.size(); }
+        inline vtkIdType NumberOfTriangles() const { return (vtkIdType)aliveTriangle.size(); }
+
+        void Build()
+        {
+            auto nv = NumberOfVertices();
+            auto nt = NumberOfTriangles();
+
+            vertexTriangles.assign(nv, {});
+            for (vtkIdType t = 0; t < nt; t++)
+            {
+                for (int c = 0; c < 3; c++) vertexTriangles[triangles[t * 3 + c]].push_back(t);
+            }
+
+            // Area weighted plane quadrics, summed per vertex over its own triangles
+            quadrics.assign(nv, Quadric());
+            vtkSMPTools::For(0, nv, [&](vtkIdType begin, vtkIdType end)
+                {
+                    for (vtkIdType v = begin; v < end; v++)
+                    {
+                        for (auto t : vertexTriangles[v])
+                        {
+                            double n[3];
+                            auto area = Normal(t, -1, nullptr, n);
+                            if (0.0 == area)
+                                continue;
+                            auto d = -vtkMath::Dot(n, &xyz[triangles[t * 3] * 3]);
+                            quadrics[v].Add(Quadric::FromPlane(n, d, area));
+                        }
+                    }
+                });
+
+            // Vertices on boundary or non-manifold edges stay where they are
+            vector<pair<vtkIdType, vtkIdType>> edges(nt * 3);
+            vtkSMPTools::For(0, nt, [&](vtkIdType begin, vtkIdType end)
+                {
+                    for (vtkIdType t = begin; t < end; t++)
+                    {
+                        for (int c = 0; c < 3; c++)
+                        {
+                            auto a = triangles[t * 3 + c];
+                            auto b = triangles[t * 3 + (c + 1) % 3];
+                            edges[t * 3 + c] = { std::min(a, b), std::max(a, b) };
+                        }
+                    }
+                });
+            vtkSMPTools::Sort(edges.begin(), edges.end());
+
+            locked.assign(nv, 0);
+            for (size_t e = 0; e < edges.size();)
+            {
+                auto next = e + 1;
+                while (next < edges.size() && edges[next] == edges[e]) next++;
+                if (2 != next - e)
+                {
+                    locked[edges[e].first] = 1;
+                    locked[edges[e].second] = 1;
+                }
+                e = next;
+            }
+
+            collapsed.assign(nv, 0);
+            versions.assign(nv, 0);
+        }
+
+        // Unit normal of a triangle, with vertex replaced by x when given, returns twice the area
+        double Normal(vtkIdType t, vtkIdType vertex, const double* x, double* n, double* compactness = nullptr) const
+        {
+            const double* p[3];
+            for (int c = 0; c < 3; c++)
+            {
+                auto id = triangles[t * 3 + c];
+                p[c] = id == vertex ? x : &xyz[id * 3];
+            }
+            double e0[3], e1[3], e2[3];
+            vtkMath::Subtract(p[1], p[0], e0);
+            vtkMath::Subtract(p[2], p[0], e1);
+            vtkMath::Cross(e0, e1, n);
+            auto length = vtkMath::Normalize(n);
+            if (nullptr != compactness)
+            {
+                // Twice the area over the squared edge lengths, 0 for slivers
+                vtkMath::Subtract(p[2], p[1], e2);
+                auto edges = vtkMath::Dot(e0, e0) + vtkMath::Dot(e1, e1) + vtkMath::Dot(e2, e2);
+                *compactness = 0.0 < edges ? length / edges : 0.0;
+            }
+            return length;
+        }
+
+        inline bool HasVertex(vtkIdType t, vtkIdType v) const
+        {
+            return triangles[t * 3] == v || triangles[t * 3 + 1] == v || triangles[t * 3 + 2] == v;
+        }
+
+        void Neighbors(vtkIdType v, vector<vtkIdType>& neighbors) const
+        {
+            neighbors.clear();
+            for (auto t : vertexTriangles[v])
+            {
+                if (0 == aliveTriangle[t])
+                    continue;
+                for (int c = 0; c < 3; c++)
+                {
+                    if (triangles[t * 3 + c] != v) neighbors.push_back(triangles[t * 3 + c]);
+                }
+            }
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        }
+
+        bool Evaluate(vtkIdType u, vtkIdType v, Candidate& candidate) const
+        {
+            if (locked[u])
+                return false;
+
+            auto quadric = quadrics[u];
+            quadric.Add(quadrics[v]);
+
+            // u moves onto v when v is locked, otherwise both move to the point of least error
+            if (locked[v] || false == quadric.Minimize(candidate.x))
+            {
+                const double* options[2] = { &xyz[v * 3], &xyz[u * 3] };
+                int count = locked[v] ? 1 : 2;
+                candidate.cost = numeric_limits<double>::max();
+                for (int o = 0; o < count; o++)
+                {
+                    auto cost = quadric.Evaluate(options[o]);
+                    if (cost < candidate.cost)
+                    {
+                        candidate.cost = cost;
+                        std::copy(options[o], options[o] + 3, candidate.x);
+                    }
+                }
+            }
+            else
+            {
+                candidate.cost = quadric.Evaluate(candidate.x);
+            }
+
+            candidate.cost = std::max(0.0, candidate.cost);
+            candidate.u = u;
+            candidate.v = v;
+            candidate.uVersion = versions[u];
+            candidate.vVersion = versions[v];
+            return true;
+        }
+
+        bool CanCollapse(const Candidate& candidate, vector<vtkIdType>& uNeighbors, vector<vtkIdType>& vNeighbors) const
+        {
+            auto u = candidate.u;
+            auto v = candidate.v;
+
+            // Link condition, the edge's triangles have to be the only ones the two rings share
+            int shared = 0;
+            for (auto t : vertexTriangles[u])
+            {
+                if (aliveTriangle[t] && HasVertex(t, v)) shared++;
+            }
+            if (0 == shared)
+                return false;
+
+            Neighbors(u, uNeighbors);
+            Neighbors(v, vNeighbors);
+            int common = 0;
+            for (size_t i = 0, j = 0; i < uNeighbors.size() && j < vNeighbors.size();)
+            {
+                if (uNeighbors[i] < vNeighbors[j]) i++;
+                else if (vNeighbors[j] < uNeighbors[i]) j++;
+                else { common++; i++; j++; }
+            }
+            if (common != shared)
+                return false;
+
+            // No remaining triangle may flip or turn into a sliver
+            for (auto vertex : { u, v })
+            {
+                for (auto t : vertexTriangles[vertex])
+                {
+                    if (0 == aliveTriangle[t] || (HasVertex(t, u) && HasVertex(t, v)))
+                        continue;
+
+                    double before[3], after[3], compactness;
+                    Normal(t, -1, nullptr, before);
+                    Normal(t, vertex, candidate.x, after, &compactness);
+                    if (compactness < 1e-2 || vtkMath::Dot(before, after) < 0.2)
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        // Moves u onto v, returns the number of triangles removed
+        int Collapse(const Candidate& candidate)
+        {
+            auto u = candidate.u;
+            auto v = candidate.v;
+
+            int removed = 0;
+            for (auto t : vertexTriangles[u])
+            {
+                if (0 == aliveTriangle[t])
+                    continue;
+                if (HasVertex(t, v))
+                {
+                    aliveTriangle[t] = 0;
+                    removed++;
+                    continue;
+                }
+                for (int c = 0; c < 3; c++)
+                {
+                    if (triangles[t * 3 + c] == u) triangles[t * 3 + c] = v;
+                }
+                vertexTriangles[v].push_back(t);
+            }
+
+            auto& vTriangles = vertexTriangles[v];
+            vTriangles.erase(std::remove_if(vTriangles.begin(), vTriangles.end(),
+                [&](vtkIdType t) { return 0 == aliveTriangle[t]; }), vTriangles.end());
+            vertexTriangles[u].clear();
+
+            std::copy(candidate.x, candidate.x + 3, &xyz[v * 3]);
+            quadrics[v].Add(quadrics[u]);
+            collapsed[u] = 1;
+            versions[u]++;
+            versions[v]++;
+            return removed;
+        }
+
+        // Greedy collapses of the cheapest edges between eligible vertices, starting from the seeds,
+        // until removeTarget triangles are gone or no edge is left
+        vtkIdType Run(const vector<vtkIdType>& seeds, const std::function<bool(vtkIdType)>& eligible, vtkIdType removeTarget)
+        {
+            if (removeTarget <= 0)
+                return 0;
+
+            std::priority_queue<Candidate, vector<Candidate>, std::greater<Candidate>> heap;
+            vector<vtkIdType> neighbors, uNeighbors, vNeighbors;
+            auto push = [&](vtkIdType a)
+                {
+                    Neighbors(a, neighbors);
+                    for (auto b : neighbors)
+                    {
+                        if (false == eligible(b))
+                            continue;
+                        Candidate candidate;
+                        if (Evaluate(a, b, candidate)) heap.push(candidate);
+                        if (Evaluate(b, a, candidate)) heap.push(candidate);
+                    }
+                };
+
+            for (auto seed : seeds)
+            {
+                if (eligible(seed)) push(seed);
+            }
+
+            vtkIdType removed = 0;
+            while (false == heap.empty() && removed < removeTarget)
+            {
+                auto candidate = heap.top();
+                heap.pop();
+                if (collapsed[candidate.u] || collapsed[candidate.v]
+                    || versions[candidate.u] != candidate.uVersion || versions[candidate.v] != candidate.vVersion)
+                    continue;
+                if (false == CanCollapse(candidate, uNeighbors, vNeighbors))
+                    continue;
+
+                removed += Collapse(candidate);
+                push(candidate.v);
+            }
+            return removed;
+        }
+    };
+}
+
+int vtkParallelQuadricDecimation::RequestData(vtkInformation* request,
+    vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector)
+{
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+    vtkPolyData* input = vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData* output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    auto inPoints = input->GetPoints();
+    auto polys = input->GetPolys();
+    if (nullptr == inPoints || nullptr == polys || 0 == polys->GetNumberOfCells())
+    {
+        output->ShallowCopy(input);
+        return 1;
+    }
+
+    Decimator decimator;
+    auto nv = input->GetNumberOfPoints();
+    decimator.xyz.resize((size_t)nv * 3);
+    vtkSMPTools::For(0, nv, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++) inPoints->GetPoint(i, &decimator.xyz[i * 3]);
+        });
+
+    {
+        vtkIdType npts;
+        const vtkIdType* pts;
+        vtkNew<vtkIdList> ids;
+        for (vtkIdType c = 0; c < polys->GetNumberOfCells(); c++)
+        {
+            polys->GetCellAtId(c, npts, pts, ids);
+            for (vtkIdType i = 2; i < npts; i++)
+            {
+                decimator.triangles.push_back(pts[0]);
+                decimator.triangles.push_back(pts[i - 1]);
+                decimator.triangles.push_back(pts[i]);
+            }
+        }
+    }
+    auto nt = (vtkIdType)(decimator.triangles.size() / 3);
+    decimator.aliveTriangle.assign(nt, 1);
+    decimator.locked.resize(nv);
+    decimator.Build();
+
+    auto target = 0 < targetNumberOfTriangles
+        ? std::min(targetNumberOfTriangles, nt)
+        : (vtkIdType)std::llround((double)nt * (1.0 - targetReduction));
+
+    // Clusters are runs of clusterSize vertices along a Morton curve over the bounding cube
+    double bounds[6];
+    inPoints->GetBounds(bounds);
+    auto extent = std::max({ bounds[1] - bounds[0], bounds[3] - bounds[2], bounds[5] - bounds[4] });
+    vector<pair<uint64_t, vtkIdType>> order(nv);
+    vtkSMPTools::For(0, nv, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                uint32_t cell[3];
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    auto t = 0.0 < extent ? (decimator.xyz[i * 3 + axis] - bounds[axis * 2]) / extent : 0.0;
+                    cell[axis] = (uint32_t)std::clamp(t * 2097151.0, 0.0, 2097151.0);
+                }
+                order[i] = { EncodeMorton(cell[0], cell[1], cell[2]), i };
+            }
+        });
+    vtkSMPTools::Sort(order.begin(), order.end());
+
+    // Two parallel rounds, the second with the clusters shifted by half a cluster so that most of the first
+    // round's seams lie inside a cluster
+    vtkIdType alive = nt;
+    vector<vtkIdType> cluster(nv);
+    vector<unsigned char> inner(nv, 0);
+    for (auto shift : { (vtkIdType)0, clusterSize / 2 })
+    {
+        auto numberOfClusters = (nv + shift + clusterSize - 1) / clusterSize;
+        for (vtkIdType r = 0; r < nv; r++)
+        {
+            cluster[order[r].second] = (r + shift) / clusterSize;
+        }
+
+        // Inner vertices have every triangle inside their cluster, so collapses between them touch no other cluster
+        vtkSMPTools::For(0, nv, [&](vtkIdType begin, vtkIdType end)
+            {
+                for (vtkIdType v = begin; v < end; v++)
+                {
+                    bool isInner = 0 == decimator.collapsed[v];
+                    for (auto t : decimator.vertexTriangles[v])
+                    {
+                        for (int c = 0; c < 3; c++)
+                        {
+                            if (cluster[decimator.triangles[t * 3 + c]] != cluster[v]) isInner = false;
+                        }
+                    }
+                    inner[v] = isInner ? 1 : 0;
+                }
+            });
+
+        vector<vtkIdType> clusterTriangles(numberOfClusters, 0);
+        for (vtkIdType t = 0; t < nt; t++)
+        {
+            auto c = cluster[decimator.triangles[t * 3]];
+            if (decimator.aliveTriangle[t]
+                && c == cluster[decimator.triangles[t * 3 + 1]] && c == cluster[decimator.triangles[t * 3 + 2]])
+                clusterTriangles[c]++;
+        }
+
+        // Every cluster removes its share of what is left to remove
+        auto removeRatio = 0 < alive ? (double)(alive - target) / (double)alive : 0.0;
+        vector<vtkIdType> clusterRemoved(numberOfClusters, 0);
+        vtkSMPTools::For(0, numberOfClusters, 1, [&](vtkIdType begin, vtkIdType end)
+            {
+                vector<vtkIdType> seeds;
+                for (vtkIdType c = begin; c < end; c++)
+                {
+                    seeds.clear();
+                    for (auto r = std::max((vtkIdType)0, c * clusterSize - shift); r < std::min(nv, (c + 1) * clusterSize - shift); r++)
+                    {
+                        seeds.push_back(order[r].second);
+                    }
+                    auto removeTarget = (vtkIdType)((double)clusterTriangles[c] * removeRatio);
+                    clusterRemoved[c] = decimator.Run(seeds, [&](vtkIdType v)
+                        {
+                            return inner[v] && 0 == decimator.collapsed[v] && cluster[v] == c;
+                        }, removeTarget);
+                }
+            });
+
+        for (auto removed : clusterRemoved) alive -= removed;
+    }
+
+    // Serial pass over the remaining seams
+    vector<vtkIdType> seeds;
+    for (vtkIdType v = 0; v < nv; v++)
+    {
+        if (0 == inner[v] && 0 == decimator.collapsed[v]) seeds.push_back(v);
+    }
+    alive -= decimator.Run(seeds, [&](vtkIdType v) { return 0 == decimator.collapsed[v]; }, alive - target);
+
+    // Compact the surviving vertices and triangles
+    vector<vtkIdType> pointMap(nv + 1, 0);
+    vector<vtkIdType> triangleMap(nt + 1, 0);
+    for (vtkIdType t = 0; t < nt; t++)
+    {
+        triangleMap[t + 1] = triangleMap[t] + decimator.aliveTriangle[t];
+        if (decimator.aliveTriangle[t])
+        {
+            for (int c = 0; c < 3; c++) pointMap[decimator.triangles[t * 3 + c] + 1] = 1;
+        }
+    }
+    for (vtkIdType i = 0; i < nv; i++)
+    {
+        pointMap[i + 1] += pointMap[i];
+    }
+
+    auto numberOfOutputPoints = pointMap[nv];
+    auto numberOfOutputTriangles = triangleMap[nt];
+
+    vtkNew<vtkPoints> newPoints;
+    newPoints->SetDataTypeToFloat();
+    newPoints->SetNumberOfPoints(numberOfOutputPoints);
+    auto newXYZ = vtkFloatArray::FastDownCast(newPoints->GetData())->GetPointer(0);
+    vtkSMPTools::For(0, nv, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                if (pointMap[i] == pointMap[i + 1])
+                    continue;
+                for (int axis = 0; axis < 3; axis++) newXYZ[pointMap[i] * 3 + axis] = (float)decimator.xyz[i * 3 + axis];
+            }
+        });
+
+    vtkNew<vtkIdTypeArray> offsets;
+    offsets->SetNumberOfTuples(numberOfOutputTriangles + 1);
+    auto offsetPointer = offsets->GetPointer(0);
+    offsetPointer[numberOfOutputTriangles] = numberOfOutputTriangles * 3;
+    vtkNew<vtkIdTypeArray> connectivity;
+    connectivity->SetNumberOfTuples(numberOfOutputTriangles * 3);
+    auto connectivityPointer = connectivity->GetPointer(0);
+    vtkSMPTools::For(0, nt, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType t = begin; t < end; t++)
+            {
+                if (0 == decimator.aliveTriangle[t])
+                    continue;
+                auto o = triangleMap[t];
+                offsetPointer[o] = o * 3;
+                for (int c = 0; c < 3; c++) connectivityPointer[o * 3 + c] = pointMap[decimator.triangles[t * 3 + c]];
+            }
+        });
+
+    vtkNew<vtkCellArray> newPolys;
+    newPolys->SetData(offsets, connectivity);
+
+    output->SetPoints(newPoints);
+    output->SetPolys(newPolys);
+
+    return 1;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Common.h>
+
+// Quadric error decimation of a triangle mesh, polygons are fan triangulated first.
+// Vertices are split into clusters of ClusterSize along a Morton curve, and every cluster collapses the edges
+// between its own inner vertices concurrently, down to its share of the triangle budget. A serial seam pass then
+// collapses the edges along the cluster borders until the budget is met.
+// Mesh boundary vertices never move, and collapses that fold a triangle or break the manifold are skipped.
+class vtkParallelQuadricDecimation : public vtkPolyDataAlgorithm
+{
+public:
+    static vtkParallelQuadricDecimation* New();
+    vtkTypeMacro(vtkParallelQuadricDecimation, vtkPolyDataAlgorithm);
+
+    // Fraction of the triangles to remove, used while TargetNumberOfTriangles is 0
+    double GetTargetReduction() const { return targetReduction; }
+    void SetTargetReduction(double reduction) { targetReduction = std::clamp(reduction, 0.0, 1.0); Modified(); }
+    vtkIdType GetTargetNumberOfTriangles() const { return targetNumberOfTriangles; }
+    void SetTargetNumberOfTriangles(vtkIdType count) { targetNumberOfTriangles = count; Modified(); }
+    vtkIdType GetClusterSize() const { return clusterSize; }
+    void SetClusterSize(vtkIdType size) { clusterSize = std::max((vtkIdType)64, size); Modified(); }
+
+protected:
+    vtkParallelQuadricDecimation() {}
+    ~vtkParallelQuadricDecimation() override {}
+
+    int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
+    double targetReduction = 0.5;
+    vtkIdType targetNumberOfTriangles = 0;
+    vtkIdType clusterSize = 8192;
+};
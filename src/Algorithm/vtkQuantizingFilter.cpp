@@ -2,56 +2,122 @@
 
 vtkStandardNewMacro(vtkQuantizingFilter);
 
-int vtkQuantizingFilter::RequestData(vtkInformation* request,
-    vtkInformationVector** inputVector,
-    vtkInformationVector* outputVector)
+namespace
 {
-    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
-    vtkPolyData* input = vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
-
-    auto points = input->GetPoints();
-
-    vtkNew<vtkPoints> newPoints;
-    newPoints->SetNumberOfPoints(imageWidth * imageHeight);
-    for (unsigned int h = 0; h < imageHeight; h++)
+    template <typename T>
+    void QuantizeArray(const T* xyz, vtkIdType nop, float* depths,
+        unsigned int imageWidth, unsigned int imageHeight, float wInterval, float hInterval)
     {
-        for (unsigned int w = 0; w < imageWidth; w++)
+        for (vtkIdType i = 0; i < nop; i++)
         {
-            float point[3];
-            point[0] = ((float)w - ((float)imageWidth * 0.5f)) * wInterval;
-            point[1] = ((float)h - ((float)imageHeight * 0.5f)) * hInterval;
-            point[2] = -1000;
+            auto x = xyz[i * 3 + 0];
+            auto y = xyz[i * 3 + 1];
+            auto z = xyz[i * 3 + 2];
+
+            // floor, not truncation, so cell w covers [(w - W/2) * wInterval, (w + 1 - W/2) * wInterval) on both sides of 0
+            auto w = (int)std::floor(x / wInterval) + (int)(imageWidth / 2);
+            auto h = (int)std::floor(y / hInterval) + (int)(imageHeight / 2);
+            if (w < 0 || h < 0 || (unsigned int)w >= imageWidth || (unsigned int)h >= imageHeight)
+                continue;
 
-            newPoints->SetPoint((vtkIdType)(h * imageWidth + w), point);
+            depths[(size_t)h * imageWidth + w] = (float)z;
         }
     }
+}
+
+void vtkQuantizingFilter::QuantizePoints(vtkPoints* points, float* depths,
+    unsigned int imageWidth, unsigned int imageHeight, float wInterval, float hInterval)
+{
+    if (nullptr == points)
+        return;
 
     auto nop = points->GetNumberOfPoints();
-    for (size_t i = 0; i < nop; i++)
+    auto data = points->GetData();
+    if (auto floatArray = vtkFloatArray::FastDownCast(data))
+    {
+        QuantizeArray(floatArray->GetPointer(0), nop, depths, imageWidth, imageHeight, wInterval, hInterval);
+    }
+    else if (auto doubleArray = vtkDoubleArray::FastDownCast(data))
+    {
+        QuantizeArray(doubleArray->GetPointer(0), nop, depths, imageWidth, imageHeight, wInterval, hInterval);
+    }
+    else
     {
-        auto p = points->GetPoint(i);
-        auto x = p[0];
-        auto y = p[1];
-        auto z = p[2];
+        for (vtkIdType i = 0; i < nop; i++)
+        {
+            double p[3];
+            points->GetPoint(i, p);
+            QuantizeArray(p, 1, depths, imageWidth, imageHeight, wInterval, hInterval);
+        }
+    }
+}
 
-        auto w = (unsigned int)(x / wInterval) + imageWidth / 2;
-        auto h = (unsigned int)(y / hInterval) + imageHeight / 2;
+void vtkQuantizingFilter::QuantizePoints(const float* xyz, size_t numberOfPoints, float* depths,
+    unsigned int imageWidth, unsigned int imageHeight, float wInterval, float hInterval)
+{
+    QuantizeArray(xyz, (vtkIdType)numberOfPoints, depths, imageWidth, imageHeight, wInterval, hInterval);
+}
 
-        auto point = newPoints->GetPoint((vtkIdType)(h * imageWidth + w));
-        point[2] = z;
-        newPoints->SetPoint((vtkIdType)(h * imageWidth + w), point);
+vtkSmartPointer<vtkPoints> vtkQuantizingFilter::DepthsToPoints(const float* depths,
+    unsigned int imageWidth, unsigned int imageHeight, float wInterval, float hInterval)
+{
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToFloat();
+    points->SetNumberOfPoints((vtkIdType)imageWidth * imageHeight);
+    auto xyz = vtkFloatArray::FastDownCast(points->GetData())->GetPointer(0);
+    for (unsigned int h = 0; h < imageHeight; h++)
+    {
+        for (unsigned int w = 0; w < imageWidth; w++)
+        {
+            auto index = (size_t)h * imageWidth + w;
+            xyz[index * 3 + 0] = ((float)w - ((float)imageWidth * 0.5f)) * wInterval;
+            xyz[index * 3 + 1] = ((float)h - ((float)imageHeight * 0.5f)) * hInterval;
+            xyz[index * 3 + 2] = depths[index];
+        }
     }
+    return points;
+}
+
+void vtkQuantizingFilter::SetGridDimensions(vtkPolyData* polyData, unsigned int imageWidth, unsigned int imageHeight)
+{
+    vtkNew<vtkIntArray> dimensions;
+    dimensions->SetName("GridDimensions");
+    dimensions->SetNumberOfComponents(2);
+    dimensions->SetNumberOfTuples(1);
+    dimensions->SetTypedComponent(0, 0, (int)imageWidth);
+    dimensions->SetTypedComponent(0, 1, (int)imageHeight);
+    polyData->GetFieldData()->AddArray(dimensions);
+}
+
+bool vtkQuantizingFilter::GetGridDimensions(vtkPolyData* polyData, unsigned int& imageWidth, unsigned int& imageHeight)
+{
+    auto dimensions = vtkIntArray::SafeDownCast(polyData->GetFieldData()->GetArray("GridDimensions"));
+    if (nullptr == dimensions || 2 != dimensions->GetNumberOfComponents() || 0 == dimensions->GetNumberOfTuples())
+        return false;
 
-    //input->SetPoints(newPoints);
-    //input->Modified();
+    imageWidth = (unsigned int)dimensions->GetTypedComponent(0, 0);
+    imageHeight = (unsigned int)dimensions->GetTypedComponent(0, 1);
+    return (vtkIdType)imageWidth * imageHeight == polyData->GetNumberOfPoints();
+}
+
+int vtkQuantizingFilter::RequestData(vtkInformation* request,
+    vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector)
+{
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+    vtkPolyData* input = vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    std::vector<float> depths((size_t)imageWidth * imageHeight, EmptyDepth);
+    QuantizePoints(input->GetPoints(), depths.data(), imageWidth, imageHeight, wInterval, hInterval);
+
+    auto newPoints = DepthsToPoints(depths.data(), imageWidth, imageHeight, wInterval, hInterval);
 
     vtkInformation* outInfo = outputVector->GetInformationObject(0);
     vtkPolyData* output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
     output->SetPoints(newPoints);
+    SetGridDimensions(output, imageWidth, imageHeight);
     output->Modified();
 
-    //output->ShallowCopy(input);
-
     return 1;
-}
\ No newline at end of file
+}
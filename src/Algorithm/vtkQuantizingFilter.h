@@ -6,7 +6,35 @@ class vtkQuantizingFilter : public vtkPolyDataAlgorithm
 {
 public:
     static vtkQuantizingFilter* New();
-    vtkQuantizingFilter(vtkQuantizingFilter, vtkPolyDataAlgorithm);
+    vtkTypeMacro(vtkQuantizingFilter, vtkPolyDataAlgorithm);
+
+    // Depth value written into grid cells that no input point falls into.
+    static constexpr float EmptyDepth = -1000.0f;
+
+    // Writes the z of every point into the row-major depth buffer cell its x/y falls into.
+    // Points outside of the grid are ignored, the last point wins when several share a cell.
+    static void QuantizePoints(vtkPoints* points, float* depths,
+        unsigned int imageWidth, unsigned int imageHeight, float wInterval, float hInterval);
+    // Same for raw float x y z, so chunks of a PointStreamReader can be quantized into one depth buffer in turn.
+    static void QuantizePoints(const float* xyz, size_t numberOfPoints, float* depths,
+        unsigned int imageWidth, unsigned int imageHeight, float wInterval, float hInterval);
+
+    // Builds the organized grid points of a depth buffer, one point per cell.
+    static vtkSmartPointer<vtkPoints> DepthsToPoints(const float* depths,
+        unsigned int imageWidth, unsigned int imageHeight, float wInterval, float hInterval);
+
+    // Grid dimensions travel with the output as a GridDimensions field data array.
+    static void SetGridDimensions(vtkPolyData* polyData, unsigned int imageWidth, unsigned int imageHeight);
+    static bool GetGridDimensions(vtkPolyData* polyData, unsigned int& imageWidth, unsigned int& imageHeight);
+
+    unsigned int GetImageWidth() const { return imageWidth; }
+    void SetImageWidth(unsigned int width) { imageWidth = width; Modified(); }
+    unsigned int GetImageHeight() const { return imageHeight; }
+    void SetImageHeight(unsigned int height) { imageHeight = height; Modified(); }
+    float GetWInterval() const { return wInterval; }
+    void SetWInterval(float interval) { wInterval = interval; Modified(); }
+    float GetHInterval() const { return hInterval; }
+    void SetHInterval(float interval) { hInterval = interval; Modified(); }
 
 protected:
     vtkQuantizingFilter() {}
@@ -0,0 +1,673 @@
+#include <App/BatchPipeline.h>
+#include <App/PatchPrefetcher.h>
+#include <App/PLYFile.h>
+#include <App/StageCache.h>
+#include <App/ThreadPool.h>
+#include <App/Utility.h>
+
+#include <Algorithm/MeshStitcher.h>
+#include <Algorithm/OrganizedPointCloud.h>
+#include <Algorithm/VDBUtility.h>
+#include <Algorithm/vtkDepthMedianFilter.h>
+#include <Algorithm/vtkGridMesher.h>
+#include <Algorithm/vtkMedianFilter.h>
+#include <Algorithm/vtkNormalEstimationFilter.h>
+#include <Algorithm/vtkParallelQuadricDecimation.h>
+#include <Algorithm/vtkQuantizingFilter.h>
+
+#include <filesystem>
+#include <iomanip>
+
+namespace
+{
+    const char* StageNames[] = { "load", "quantize", "filter", "normals", "voxelize", "volume", "mesh", "decimate", "write" };
+
+    struct PatchState
+    {
+        vtkSmartPointer<vtkPolyData> points;
+        bool organized = false;
+        openvdb::FloatGrid::Ptr grid;
+        vector<VolumeStepReport> volumeReports;
+        vtkSmartPointer<vtkPolyData> mesh;
+    };
+
+    // Drops the empty cells of an organized grid, the later stages only want measured points
+    vtkSmartPointer<vtkPolyData> ValidPoints(const PatchState& state)
+    {
+        if (false == state.organized)
+            return state.points;
+
+        OrganizedPointCloud cloud;
+        if (false == OrganizedPointCloud::FromPolyData(state.points, cloud))
+            return state.points;
+        auto validPoints = cloud.ToPolyData(true);
+
+        // Normals of the valid cells follow them into the compact points
+        auto normals = state.points->GetPointData()->GetNormals();
+        if (nullptr != normals)
+        {
+            vtkNew<vtkFloatArray> validNormals;
+            validNormals->SetName(normals->GetName());
+            validNormals->SetNumberOfComponents(3);
+            validNormals->SetNumberOfTuples(validPoints->GetNumberOfPoints());
+            vtkIdType o = 0;
+            for (size_t i = 0; i < cloud.GetNumberOfPoints(); i++)
+            {
+                if (cloud.IsValid(i)) validNormals->SetTuple(o++, normals->GetTuple(i));
+            }
+            validPoints->GetPointData()->SetNormals(validNormals);
+        }
+        return validPoints;
+    }
+
+    // Gives every mesh vertex the normal of the closest source point, the meshers and the decimation drop point data
+    void TransferNormals(vtkPolyData* source, vtkPolyData* mesh)
+    {
+        auto normals = nullptr != source ? source->GetPointData()->GetNormals() : nullptr;
+        if (nullptr == normals || 0 == source->GetNumberOfPoints() || nullptr == mesh || 0 == mesh->GetNumberOfPoints())
+            return;
+
+        vtkNew<vtkStaticPointLocator> locator;
+        locator->SetDataSet(source);
+        locator->BuildLocator();
+
+        vtkNew<vtkFloatArray> meshNormals;
+        meshNormals->SetName("Normals");
+        meshNormals->SetNumberOfComponents(3);
+        meshNormals->SetNumberOfTuples(mesh->GetNumberOfPoints());
+        auto meshNormalPointer = meshNormals->GetPointer(0);
+        auto points = mesh->GetPoints();
+        vtkSMPTools::For(0, mesh->GetNumberOfPoints(), [&](vtkIdType begin, vtkIdType end)
+            {
+                for (vtkIdType i = begin; i < end; i++)
+                {
+                    double p[3];
+                    points->GetPoint(i, p);
+                    double n[3];
+                    normals->GetTuple(locator->FindClosestPoint(p), n);
+                    for (int axis = 0; axis < 3; axis++) meshNormalPointer[i * 3 + axis] = (float)n[axis];
+                }
+            });
+        mesh->GetPointData()->SetNormals(meshNormals);
+    }
+
+    // Rasterizes an organized grid's depths straight into a distance field, its points stay in the grid layout
+    openvdb::FloatGrid::Ptr OrganizedToSDF(vtkPolyData* grid, const BatchOptions& options)
+    {
+        unsigned int width, height;
+        if (false == vtkQuantizingFilter::GetGridDimensions(grid, width, height))
+            return nullptr;
+
+        auto points = grid->GetPoints();
+        vector<float> depths((size_t)width * height);
+        vtkSMPTools::For(0, points->GetNumberOfPoints(), [&](vtkIdType begin, vtkIdType end)
+            {
+                for (vtkIdType i = begin; i < end; i++)
+                {
+                    double p[3];
+                    points->GetPoint(i, p);
+                    depths[i] = (float)p[2];
+                }
+            });
+        return DepthsToSDF(depths.data(), width, height, options.wInterval, options.hInterval,
+            options.voxelSize, options.narrowBandWidth, vtkQuantizingFilter::EmptyDepth);
+    }
+
+    bool RunStage(BatchStage stage, const BatchOptions& options, const string& filePath, PatchState& state)
+    {
+        switch (stage)
+        {
+        case BatchStage::Load:
+        {
+            state.points = ReadPLY(filePath);
+            state.organized = false;
+            if (nullptr == state.points || 0 == state.points->GetNumberOfPoints())
+                return false;
+            break;
+        }
+        case BatchStage::Quantize:
+        {
+            if (nullptr == state.points)
+                return false;
+
+            vtkNew<vtkQuantizingFilter> quantizingFilter;
+            quantizingFilter->SetImageWidth(options.imageWidth);
+            quantizingFilter->SetImageHeight(options.imageHeight);
+            quantizingFilter->SetWInterval(options.wInterval);
+            quantizingFilter->SetHInterval(options.hInterval);
+            quantizingFilter->SetInputData(state.points);
+            quantizingFilter->Update();
+            state.points = quantizingFilter->GetOutput();
+            state.organized = true;
+            break;
+        }
+        case BatchStage::Filter:
+        {
+            if (nullptr == state.points)
+                return false;
+
+            if (state.organized)
+            {
+                vtkNew<vtkDepthMedianFilter> depthMedianFilter;
+                depthMedianFilter->SetKernelSize(options.kernelSize);
+                depthMedianFilter->SetInputData(state.points);
+                depthMedianFilter->Update();
+                state.points = depthMedianFilter->GetOutput();
+            }
+            else
+            {
+                vtkNew<vtkMedianFilter> medianFilter;
+                medianFilter->SetMode(vtkMedianFilter::STATISTICAL_OUTLIER_REMOVAL);
+                medianFilter->SetInputData(state.points);
+                medianFilter->Update();
+                state.points = medianFilter->GetOutput();
+            }
+            break;
+        }
+        case BatchStage::Normals:
+        {
+            if (nullptr == state.points)
+                return false;
+
+            vtkNew<vtkNormalEstimationFilter> normalEstimation;
+            normalEstimation->SetNumberOfNeighbors(options.normalNeighbors);
+            normalEstimation->SetInputData(state.points);
+            normalEstimation->Update();
+            state.points = normalEstimation->GetOutput();
+            break;
+        }
+        case BatchStage::Voxelize:
+        {
+            if (nullptr == state.points)
+                return false;
+
+            if (state.organized && 0.0f < options.narrowBandWidth)
+                state.grid = OrganizedToSDF(state.points, options);
+            else
+                state.grid = CreateVDBVolume(ValidPoints(state), options.voxelSize, options.narrowBandWidth, options.particleRadius);
+            if (nullptr == state.grid)
+                return false;
+            break;
+        }
+        case BatchStage::Volume:
+        {
+            if (nullptr == state.grid)
+                return false;
+
+            state.volumeReports.clear();
+            FilterVolume(*state.grid, options.volumeSteps, &state.volumeReports);
+            break;
+        }
+        case BatchStage::Mesh:
+        {
+            // Without a grid the quantized depth grid is triangulated directly
+            if (nullptr == state.grid && state.organized && nullptr != state.points)
+            {
+                vtkNew<vtkGridMesher> gridMesher;
+                gridMesher->SetMaxEdgeLength(options.maxEdgeLength);
+                gridMesher->SetCompact(true);
+                gridMesher->SetInputData(state.points);
+                gridMesher->Update();
+                state.mesh = gridMesher->GetOutput();
+            }
+            else
+            {
+                if (nullptr == state.grid)
+                    return false;
+
+                auto isovalue = openvdb::GRID_LEVEL_SET == state.grid->getGridClass() ? 0.0 : options.isovalue;
+                state.mesh = VDBToMesh(state.grid, isovalue, options.adaptivity);
+            }
+
+            // Estimated normals end up on the mesh vertices
+            if (nullptr != state.points && nullptr != state.points->GetPointData()->GetNormals())
+                TransferNormals(ValidPoints(state), state.mesh);
+            break;
+        }
+        case BatchStage::Decimate:
+        {
+            if (nullptr == state.mesh)
+                return false;
+
+            vtkNew<vtkParallelQuadricDecimation> decimation;
+            decimation->SetTargetReduction(options.decimateReduction);
+            decimation->SetInputData(state.mesh);
+            decimation->Update();
+            TransferNormals(state.mesh, decimation->GetOutput());
+            state.mesh = decimation->GetOutput();
+            break;
+        }
+        case BatchStage::Write:
+        {
+            if (options.outputDirectory.empty())
+                return false;
+
+            auto outputPath = std::filesystem::path(options.outputDirectory) / std::filesystem::path(filePath).filename();
+            auto data = nullptr != state.mesh ? state.mesh : ValidPoints(state);
+            if (nullptr == data)
+                return false;
+            if (false == WritePLY(data, outputPath.string()))
+                return false;
+            break;
+        }
+        default:
+            return false;
+        }
+
+        return true;
+    }
+
+    // Chains the key of the previous stage with the stage and the parameters it depends on
+    uint64_t StageKey(uint64_t previousKey, BatchStage stage, const BatchOptions& options)
+    {
+        StageHash hash(previousKey);
+        hash.Add((int)stage);
+        switch (stage)
+        {
+        case BatchStage::Quantize:
+            hash.Add(options.imageWidth).Add(options.imageHeight).Add(options.wInterval).Add(options.hInterval);
+            break;
+        case BatchStage::Filter:
+            hash.Add(options.kernelSize);
+            break;
+        case BatchStage::Normals:
+            hash.Add(options.normalNeighbors);
+            break;
+        case BatchStage::Voxelize:
+            hash.Add(options.voxelSize).Add(options.narrowBandWidth).Add(options.particleRadius);
+            break;
+        case BatchStage::Volume:
+            for (auto& step : options.volumeSteps)
+            {
+                hash.Add((int)step.operation).Add(step.width).Add(step.iterations);
+            }
+            break;
+        case BatchStage::Mesh:
+            hash.Add(options.isovalue).Add(options.adaptivity).Add(options.maxEdgeLength);
+            break;
+        case BatchStage::Decimate:
+            hash.Add(options.decimateReduction);
+            break;
+        default:
+            break;
+        }
+        return hash.Get();
+    }
+
+    // Load reads the input itself and Write produces no data, the stages in between are memoized.
+    // Cached PLY files keep the normals, so points and meshes after the normals stage resume with them.
+    inline bool IsCacheable(BatchStage stage)
+    {
+        return BatchStage::Load != stage && BatchStage::Write != stage;
+    }
+
+    // A cached stage only restores its own output, so resuming after it requires the remaining stages to need nothing else
+    bool CanResumeAfter(const vector<BatchStage>& stages, size_t cachedStage)
+    {
+        bool hasPoints = BatchStage::Quantize == stages[cachedStage] || BatchStage::Filter == stages[cachedStage]
+            || BatchStage::Normals == stages[cachedStage];
+        bool hasGrid = BatchStage::Voxelize == stages[cachedStage] || BatchStage::Volume == stages[cachedStage];
+        bool hasMesh = BatchStage::Mesh == stages[cachedStage] || BatchStage::Decimate == stages[cachedStage];
+        for (size_t i = cachedStage + 1; i < stages.size(); i++)
+        {
+            switch (stages[i])
+            {
+            case BatchStage::Load: hasPoints = true; break;
+            case BatchStage::Quantize:
+            case BatchStage::Filter:
+            case BatchStage::Normals: if (false == hasPoints) return false; break;
+            case BatchStage::Voxelize: if (false == hasPoints) return false; hasGrid = true; break;
+            case BatchStage::Volume: if (false == hasGrid) return false; break;
+            case BatchStage::Mesh:
+                if (false == hasGrid && false == hasPoints) return false;
+                // The mesh takes its normals from the points, a cached grid alone would give a mesh without them
+                if (false == hasPoints && stages.begin() + i != std::find(stages.begin(), stages.begin() + i, BatchStage::Normals)) return false;
+                hasMesh = true;
+                break;
+            case BatchStage::Decimate: if (false == hasMesh) return false; break;
+            case BatchStage::Write: if (false == hasPoints && false == hasMesh) return false; break;
+            default: return false;
+            }
+        }
+        return true;
+    }
+
+    // Releases a pinned cache entry when the patch is done with it
+    struct CachePin
+    {
+        StageCache* cache = nullptr;
+        uint64_t key = 0;
+        string extension;
+
+        ~CachePin()
+        {
+            if (nullptr != cache)
+                cache->Release(key, extension);
+        }
+    };
+
+    inline bool IsGridStage(BatchStage stage)
+    {
+        return BatchStage::Voxelize == stage || BatchStage::Volume == stage;
+    }
+
+    const char* CacheExtension(BatchStage stage)
+    {
+        return IsGridStage(stage) ? ".vdb" : ".ply";
+    }
+
+    bool LoadCachedStage(StageCache& cache, uint64_t key, BatchStage stage, bool organized,
+        const BatchOptions& options, PatchState& state)
+    {
+        // Delay loaded grids keep reading the mapped file, so their entry stays pinned until the patch is done
+        return cache.Load(key, CacheExtension(stage), [&](const std::string& path)
+            {
+                switch (stage)
+                {
+                case BatchStage::Voxelize:
+                case BatchStage::Volume:
+                    // Delay loaded, the mesh stage reads the leaf values straight from the mapped cache file
+                    state.grid = ReadVDB(path, true);
+                    return nullptr != state.grid;
+                case BatchStage::Mesh:
+                case BatchStage::Decimate:
+                    state.mesh = ReadPLY(path);
+                    return nullptr != state.mesh;
+                default:
+                {
+                    state.points = ReadPLY(path);
+                    state.organized = organized;
+                    if (nullptr == state.points)
+                        return false;
+                    // PLY keeps no field data, the grid layout comes from the options the key was made of
+                    if (organized)
+                    {
+                        vtkQuantizingFilter::SetGridDimensions(state.points, options.imageWidth, options.imageHeight);
+                        unsigned int w, h;
+                        return vtkQuantizingFilter::GetGridDimensions(state.points, w, h);
+                    }
+                    return true;
+                }
+                }
+            }, IsGridStage(stage));
+    }
+
+    bool StoreStage(StageCache& cache, uint64_t key, BatchStage stage, const BatchOptions& options, const PatchState& state)
+    {
+        return cache.Store(key, CacheExtension(stage), [&](const std::string& path)
+            {
+                switch (stage)
+                {
+                case BatchStage::Voxelize:
+                case BatchStage::Volume:
+                    return WriteVDB(state.grid, path, options.gridCompression);
+                case BatchStage::Mesh:
+                case BatchStage::Decimate:
+                    return WritePLYBinary(state.mesh, path);
+                default:
+                    return WritePLYBinary(state.points, path);
+                }
+            });
+    }
+}
+
+const char* GetBatchStageName(BatchStage stage)
+{
+    return StageNames[(int)stage];
+}
+
+bool ParseBatchStages(const string& text, vector<BatchStage>& stages)
+{
+    stages.clear();
+    stringstream ss(text);
+    string name;
+    while (std::getline(ss, name, ','))
+    {
+        auto it = std::find_if(std::begin(StageNames), std::end(StageNames),
+            [&](const char* stageName) { return name == stageName; });
+        if (std::end(StageNames) == it)
+            return false;
+        stages.push_back((BatchStage)(it - std::begin(StageNames)));
+    }
+    return false == stages.empty();
+}
+
+BatchPipeline::BatchPipeline(const BatchOptions& options)
+    : options(options)
+{
+}
+
+BatchPipeline::~BatchPipeline()
+{
+}
+
+bool BatchPipeline::Run()
+{
+    auto filePaths = PatchPrefetcher::ListPatches(options.inputDirectory);
+    numberOfPatches = filePaths.size();
+    numberOfFailures = 0;
+    if (false == options.outputDirectory.empty())
+    {
+        std::filesystem::create_directories(options.outputDirectory);
+    }
+
+    cache.reset();
+    if (false == options.cacheDirectory.empty())
+    {
+        cache = std::make_unique<StageCache>(options.cacheDirectory, options.cacheBytes);
+    }
+
+    auto beginTime = chrono::steady_clock::now();
+    {
+        ThreadPool pool(options.numberOfThreads);
+        patchMeshes.assign(filePaths.size(), nullptr);
+        vector<std::future<bool>> results;
+        results.reserve(filePaths.size());
+        for (size_t index = 0; index < filePaths.size(); index++)
+        {
+            results.push_back(pool.Enqueue([this, filePath = filePaths[index], index]()
+                {
+                    return ProcessPatch(filePath, index);
+                }));
+        }
+
+        // Exceptions thrown by a stage end up in the patch's future and count as failures too
+        for (size_t index = 0; index < results.size(); index++)
+        {
+            string error;
+            try
+            {
+                if (false == results[index].get())
+                    error = "failed";
+            }
+            catch (const std::exception& e)
+            {
+                error = e.what();
+            }
+            catch (...)
+            {
+                error = "unknown exception";
+            }
+
+            if (false == error.empty())
+            {
+                std::cerr << "Failed to process " << filePaths[index] << ": " << error << std::endl;
+                numberOfFailures++;
+            }
+        }
+    }
+
+    if (false == options.stitchedFilePath.empty())
+    {
+        auto stitchBeginTime = chrono::steady_clock::now();
+
+        // Patches are stitched in file order, earlier patches keep the overlaps
+        MeshStitcher stitcher(options.stitchOverlapDistance, options.stitchSnapDistance);
+        for (auto& mesh : patchMeshes)
+        {
+            stitcher.AddPatch(mesh);
+        }
+        patchMeshes.clear();
+
+        auto stitched = stitcher.Stitch();
+        stitchStatistics = stitcher.GetStatistics();
+        if (false == WritePLYBinary(stitched, options.stitchedFilePath))
+        {
+            std::cerr << "Failed to write " << options.stitchedFilePath << std::endl;
+            numberOfFailures++;
+        }
+        stitchMiliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - stitchBeginTime).count();
+    }
+    wallMiliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - beginTime).count();
+
+    return 0 == numberOfFailures;
+}
+
+bool BatchPipeline::ProcessPatch(const string& filePath, size_t index)
+{
+    auto& stages = options.stages;
+    // Declared before the state, so the grid that maps the pinned file is gone when the pin is released
+    CachePin pin;
+    PatchState state;
+    size_t firstStage = 0;
+
+    vector<uint64_t> keys(stages.size(), 0);
+    if (nullptr != cache)
+    {
+        auto beginTime = chrono::steady_clock::now();
+
+        // Keys only depend on the input file and the parameters, so they are all known up front
+        StageHash hash;
+        if (false == hash.AddFile(filePath))
+            return false;
+        auto key = hash.Get();
+        for (size_t i = 0; i < stages.size(); i++)
+        {
+            keys[i] = key = StageKey(key, stages[i], options);
+        }
+
+        // Resume after the last stage whose output is cached, the stages before it are skipped entirely
+        for (size_t i = stages.size(); 0 < i; i--)
+        {
+            if (false == IsCacheable(stages[i - 1]) || false == CanResumeAfter(stages, i - 1))
+                continue;
+
+            bool organized = std::find(stages.begin(), stages.begin() + i, BatchStage::Quantize) != stages.begin() + i;
+            if (LoadCachedStage(*cache, keys[i - 1], stages[i - 1], organized, options, state))
+            {
+                if (IsGridStage(stages[i - 1]))
+                {
+                    pin.cache = cache.get();
+                    pin.key = keys[i - 1];
+                    pin.extension = CacheExtension(stages[i - 1]);
+                }
+                firstStage = i;
+                break;
+            }
+        }
+
+        cacheTiming.nanoseconds += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - beginTime).count();
+        cacheTiming.numberOfPatches++;
+    }
+
+    for (size_t i = firstStage; i < stages.size(); i++)
+    {
+        auto stage = stages[i];
+        auto beginTime = chrono::steady_clock::now();
+
+        if (false == RunStage(stage, options, filePath, state))
+            return false;
+
+        auto& timing = timings[(int)stage];
+        timing.nanoseconds += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - beginTime).count();
+        timing.numberOfPatches++;
+
+        for (auto& report : state.volumeReports)
+        {
+            auto operation = (int)report.step.operation;
+            volumeTimings[operation].nanoseconds += (int64_t)(report.miliseconds * 1000000.0);
+            volumeTimings[operation].numberOfPatches++;
+            auto peak = volumePeakBytes[operation].load();
+            while (peak < report.memoryBytes && false == volumePeakBytes[operation].compare_exchange_weak(peak, report.memoryBytes))
+            {
+            }
+        }
+        state.volumeReports.clear();
+
+        if (nullptr != cache && IsCacheable(stage))
+        {
+            beginTime = chrono::steady_clock::now();
+            StoreStage(*cache, keys[i], stage, options, state);
+            cacheTiming.nanoseconds += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - beginTime).count();
+        }
+    }
+
+    // Every task owns its own slot
+    if (false == options.stitchedFilePath.empty())
+        patchMeshes[index] = state.mesh;
+
+    return true;
+}
+
+void BatchPipeline::PrintReport(std::ostream& os) const
+{
+    os << std::fixed << std::setprecision(3);
+    os << std::left << std::setw(10) << "stage" << std::right
+        << std::setw(10) << "patches" << std::setw(14) << "total ms" << std::setw(14) << "ms/patch" << std::endl;
+
+    for (int s = 0; s < (int)BatchStage::Count; s++)
+    {
+        auto& timing = timings[s];
+        if (0 == timing.numberOfPatches)
+            continue;
+
+        auto totalMiliseconds = (double)timing.nanoseconds.load() / 1000000.0;
+        os << std::left << std::setw(10) << StageNames[s] << std::right
+            << std::setw(10) << timing.numberOfPatches
+            << std::setw(14) << totalMiliseconds
+            << std::setw(14) << totalMiliseconds / (double)timing.numberOfPatches << std::endl;
+    }
+
+    // Volume steps are timed inside the volume stage, with the largest grid memory each one left
+    for (int o = 0; o < (int)VolumeOperation::Count; o++)
+    {
+        auto& timing = volumeTimings[o];
+        if (0 == timing.numberOfPatches)
+            continue;
+
+        auto totalMiliseconds = (double)timing.nanoseconds.load() / 1000000.0;
+        os << std::left << std::setw(10) << string(" ") + GetVolumeOperationName((VolumeOperation)o) << std::right
+            << std::setw(10) << timing.numberOfPatches
+            << std::setw(14) << totalMiliseconds
+            << std::setw(14) << totalMiliseconds / (double)timing.numberOfPatches
+            << "  peak " << (double)volumePeakBytes[o].load() / (1024.0 * 1024.0) << " MB" << std::endl;
+    }
+
+    if (0 < cacheTiming.numberOfPatches)
+    {
+        auto totalMiliseconds = (double)cacheTiming.nanoseconds.load() / 1000000.0;
+        os << std::left << std::setw(10) << "cache" << std::right
+            << std::setw(10) << cacheTiming.numberOfPatches
+            << std::setw(14) << totalMiliseconds
+            << std::setw(14) << totalMiliseconds / (double)cacheTiming.numberOfPatches << std::endl;
+    }
+    if (nullptr != cache)
+    {
+        auto statistics = cache->GetStatistics();
+        os << "cache " << statistics.hits << " hits, " << statistics.misses << " misses, "
+            << statistics.insertions << " insertions, " << statistics.evictions << " evictions, "
+            << statistics.numberOfEntries << " entries, " << statistics.numberOfBytes << " bytes" << std::endl;
+    }
+
+    if (false == options.stitchedFilePath.empty())
+    {
+        os << "stitch " << stitchMiliseconds << " ms, " << stitchStatistics.numberOfPairs << " overlapping pairs, "
+            << stitchStatistics.removedTriangles << " overlapping triangles removed, "
+            << stitchStatistics.snappedPoints << " seam points snapped" << std::endl;
+    }
+
+    // Stage times are summed over all threads, the wall time is what the batch took
+    auto processed = numberOfPatches - numberOfFailures.load();
+    os << processed << " of " << numberOfPatches << " patches in " << wallMiliseconds << " ms, "
+        << (0.0 < wallMiliseconds ? (double)processed * 1000.0 / wallMiliseconds : 0.0) << " patches/s" << std::endl;
+}
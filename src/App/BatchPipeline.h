@@ -0,0 +1,124 @@
+#pragma once
+
+#include <Common.h>
+
+#include <Algorithm/MeshStitcher.h>
+#include <Algorithm/VDBUtility.h>
+#include <Algorithm/VolumeFilter.h>
+
+#include <atomic>
+
+class StageCache;
+
+enum class BatchStage
+{
+    Load = 0,
+    Quantize,
+    Filter,
+    Normals,
+    Voxelize,
+    Volume,
+    Mesh,
+    Decimate,
+    Write,
+    Count
+};
+
+const char* GetBatchStageName(BatchStage stage);
+// Comma separated stage names such as "load,quantize,filter", false on an unknown name
+bool ParseBatchStages(const string& text, vector<BatchStage>& stages);
+
+struct BatchOptions
+{
+    string inputDirectory;
+    string outputDirectory;
+    vector<BatchStage> stages = {
+        BatchStage::Load, BatchStage::Quantize, BatchStage::Filter,
+        BatchStage::Voxelize, BatchStage::Mesh, BatchStage::Write };
+    // 0 means one per hardware thread
+    size_t numberOfThreads = 0;
+
+    unsigned int imageWidth = 256;
+    unsigned int imageHeight = 480;
+    float wInterval = 0.1f;
+    float hInterval = 0.1f;
+    int kernelSize = 3;
+    // Neighbours per point of the normals stage
+    int normalNeighbors = 16;
+    float voxelSize = 0.1f;
+    // In voxels, 0 voxelizes occupancy and anything above builds a level set, the depth distance field of the
+    // quantized grid after Quantize and spheres of particleRadius otherwise
+    float narrowBandWidth = 0.0f;
+    float particleRadius = 0.0f;
+    // Morphology and smoothing applied to the grid by the volume stage
+    vector<VolumeStep> volumeSteps;
+    // Occupancy grids are meshed at isovalue, level sets at their zero crossing
+    double isovalue = 0.5;
+    double adaptivity = 0.0;
+    // Longest triangle edge when Mesh triangulates the quantized grid because there is no voxelize stage
+    float maxEdgeLength = 0.2f;
+    // Fraction of the mesh triangles the decimate stage removes
+    double decimateReduction = 0.5;
+
+    // When set, the patch meshes are stitched into this one file after the batch
+    string stitchedFilePath;
+    double stitchOverlapDistance = 0.1;
+    double stitchSnapDistance = 0.05;
+
+    // Stage outputs are memoized there when it is set
+    string cacheDirectory;
+    uint64_t cacheBytes = 4ull << 30;
+    // Compression of the cached grids, which does not change their keys
+    VDBCompression gridCompression = VDBCompression::Blosc;
+};
+
+struct BatchStageTiming
+{
+    std::atomic<int64_t> nanoseconds{ 0 };
+    std::atomic<size_t> numberOfPatches{ 0 };
+};
+
+// Runs the stage list over every patch of the input directory, one patch per thread pool task.
+// Filter works on the depth grid after Quantize and removes statistical outliers otherwise,
+// Normals estimates point normals, which a level set voxelize of unorganized points then follows
+// and which the mesh vertices take from their closest point,
+// Volume runs the volume steps on the grid between Voxelize and Mesh,
+// Mesh extracts the grid surface, or triangulates the quantized grid when nothing was voxelized,
+// Decimate reduces the mesh by quadric edge collapses,
+// Write stores the mesh when there is one and the points otherwise, with nx ny nz when they have normals.
+// With a stitched file path the patch meshes are kept and stitched into one mesh once all patches are done.
+// With a cache directory every stage between Load and Write is keyed by the input file contents and the parameters
+// of the stages up to it, and a patch resumes after the last stage found in the cache.
+class BatchPipeline
+{
+public:
+    BatchPipeline(const BatchOptions& options);
+    ~BatchPipeline();
+
+    // Returns false when any patch failed
+    bool Run();
+    void PrintReport(std::ostream& os) const;
+
+    inline size_t GetNumberOfPatches() const { return numberOfPatches; }
+    inline size_t GetNumberOfFailures() const { return numberOfFailures; }
+    inline double GetWallMiliseconds() const { return wallMiliseconds; }
+
+private:
+    BatchOptions options;
+    BatchStageTiming timings[(int)BatchStage::Count];
+    // Per volume operation, with the largest grid it left behind
+    BatchStageTiming volumeTimings[(int)VolumeOperation::Count];
+    std::atomic<uint64_t> volumePeakBytes[(int)VolumeOperation::Count] = {};
+    // Key hashing, cache lookups and stores
+    BatchStageTiming cacheTiming;
+    std::unique_ptr<StageCache> cache;
+    size_t numberOfPatches = 0;
+    std::atomic<size_t> numberOfFailures{ 0 };
+    double wallMiliseconds = 0.0;
+
+    vector<vtkSmartPointer<vtkPolyData>> patchMeshes;
+    MeshStitchStatistics stitchStatistics;
+    double stitchMiliseconds = 0.0;
+
+    bool ProcessPatch(const string& filePath, size_t index);
+};
@@ -0,0 +1,80 @@
+#include <App/MappedFile.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::Open(const std::string& filePath)
+{
+    Close();
+
+#ifdef _WIN32
+    fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (INVALID_HANDLE_VALUE == fileHandle)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (FALSE == GetFileSizeEx(fileHandle, &fileSize) || 0 == fileSize.QuadPart)
+    {
+        Close();
+        return false;
+    }
+    size = (size_t)fileSize.QuadPart;
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (nullptr == mappingHandle)
+    {
+        Close();
+        return false;
+    }
+
+    data = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+#else
+    fileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+        return false;
+
+    struct stat fileStat;
+    if (0 != fstat(fileDescriptor, &fileStat) || 0 == fileStat.st_size)
+    {
+        Close();
+        return false;
+    }
+    size = (size_t)fileStat.st_size;
+
+    auto mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    if (MAP_FAILED != mapped)
+    {
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        data = (const char*)mapped;
+    }
+#endif
+
+    if (nullptr == data)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (nullptr != data) UnmapViewOfFile(data);
+    if (nullptr != mappingHandle) CloseHandle(mappingHandle);
+    if (INVALID_HANDLE_VALUE != fileHandle) CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = INVALID_HANDLE_VALUE;
+#else
+    if (nullptr != data) munmap((void*)data, size);
+    if (0 <= fileDescriptor) close(fileDescriptor);
+    fileDescriptor = -1;
+#endif
+    data = nullptr;
+    size = 0;
+}
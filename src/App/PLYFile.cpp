@@ -0,0 +1,597 @@
+#include <App/PLYFile.h>
+#include <App/MappedFile.h>
+
+#include <charconv>
+#include <cstring>
+#include <atomic>
+
+namespace
+{
+    inline bool IsBlank(char c)
+    {
+        return ' ' == c || '\t' == c || '\r' == c;
+    }
+
+    // Bulk copies below assume a little-endian host, which is every platform this builds for
+    inline bool IsFloatType(const string& type) { return "float" == type || "float32" == type; }
+    inline bool IsDoubleType(const string& type) { return "double" == type || "float64" == type; }
+
+    size_t CountLines(const char* begin, const char* end)
+    {
+        size_t count = 0;
+        bool hasContent = false;
+        for (auto p = begin; p < end; p++)
+        {
+            if ('\n' == *p)
+            {
+                if (hasContent) count++;
+                hasContent = false;
+            }
+            else if (false == IsBlank(*p))
+            {
+                hasContent = true;
+            }
+        }
+        if (hasContent) count++;
+        return count;
+    }
+}
+
+bool PLYHeader::Parse(const char* data, size_t size, PLYHeader& header)
+{
+    header = PLYHeader();
+
+    auto end = data + size;
+    auto lineBegin = data;
+    bool first = true;
+    while (lineBegin < end)
+    {
+        auto lineEnd = (const char*)memchr(lineBegin, '\n', end - lineBegin);
+        if (nullptr == lineEnd)
+            return false;
+
+        stringstream ss(string(lineBegin, lineEnd));
+        lineBegin = lineEnd + 1;
+
+        string keyword;
+        ss >> keyword;
+
+        if (first)
+        {
+            if ("ply" != keyword) return false;
+            first = false;
+        }
+        else if ("format" == keyword)
+        {
+            string format;
+            ss >> format;
+            if ("ascii" == format) header.format = ASCII;
+            else if ("binary_little_endian" == format) header.format = BinaryLittleEndian;
+            else if ("binary_big_endian" == format) header.format = BinaryBigEndian;
+            else return false;
+        }
+        else if ("element" == keyword)
+        {
+            Element element;
+            ss >> element.name >> element.count;
+            header.elements.push_back(element);
+        }
+        else if ("property" == keyword)
+        {
+            if (header.elements.empty()) return false;
+
+            Property property;
+            ss >> property.type;
+            if ("list" == property.type)
+            {
+                property.isList = true;
+                ss >> property.countType >> property.type;
+            }
+            ss >> property.name;
+            header.elements.back().properties.push_back(property);
+        }
+        else if ("end_header" == keyword)
+        {
+            header.headerSize = lineBegin - data;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t PLYHeader::TypeSize(const string& type)
+{
+    if ("char" == type || "uchar" == type || "int8" == type || "uint8" == type) return 1;
+    if ("short" == type || "ushort" == type || "int16" == type || "uint16" == type) return 2;
+    if ("int" == type || "uint" == type || "int32" == type || "uint32" == type) return 4;
+    if ("float" == type || "float32" == type) return 4;
+    if ("double" == type || "float64" == type) return 8;
+    return 0;
+}
+
+bool ParseASCIIVertices(const char* begin, const char* end, size_t numberOfVertices,
+    int numberOfProperties, const int xyzIndex[3], float* xyz)
+{
+    // Chunks start right after a line break, so no line is split between two threads
+    const size_t chunkSize = 1 << 18;
+    auto numberOfChunks = std::max((size_t)1, (size_t)(end - begin) / chunkSize);
+
+    vector<const char*> chunkBegins(numberOfChunks + 1);
+    chunkBegins[0] = begin;
+    chunkBegins[numberOfChunks] = end;
+    for (size_t k = 1; k < numberOfChunks; k++)
+    {
+        auto p = std::max(chunkBegins[k - 1], begin + k * (size_t)(end - begin) / numberOfChunks);
+        auto lineBreak = (const char*)memchr(p, '\n', end - p);
+        chunkBegins[k] = nullptr == lineBreak ? end : lineBreak + 1;
+    }
+
+    vector<size_t> firstVertex(numberOfChunks + 1, 0);
+    vtkSMPTools::For(0, (vtkIdType)numberOfChunks, [&](vtkIdType b, vtkIdType e)
+        {
+            for (vtkIdType k = b; k < e; k++)
+            {
+                firstVertex[k + 1] = CountLines(chunkBegins[k], chunkBegins[k + 1]);
+            }
+        });
+    for (size_t k = 0; k < numberOfChunks; k++)
+    {
+        firstVertex[k + 1] += firstVertex[k];
+    }
+    if (firstVertex[numberOfChunks] < numberOfVertices)
+        return false;
+
+    std::atomic<bool> failed(false);
+    vtkSMPTools::For(0, (vtkIdType)numberOfChunks, [&](vtkIdType b, vtkIdType e)
+        {
+            for (vtkIdType k = b; k < e && false == failed; k++)
+            {
+                auto vertex = firstVertex[k];
+                auto p = chunkBegins[k];
+                auto chunkEnd = chunkBegins[k + 1];
+
+                while (p < chunkEnd && vertex < numberOfVertices)
+                {
+                    auto lineEnd = (const char*)memchr(p, '\n', chunkEnd - p);
+                    if (nullptr == lineEnd) lineEnd = chunkEnd;
+
+                    while (p < lineEnd && IsBlank(*p)) p++;
+                    if (p == lineEnd)
+                    {
+                        p = lineEnd + 1;
+                        continue;
+                    }
+
+                    for (int j = 0; j < numberOfProperties; j++)
+                    {
+                        while (p < lineEnd && IsBlank(*p)) p++;
+                        if (p == lineEnd)
+                        {
+                            failed = true;
+                            return;
+                        }
+
+                        int axis = -1;
+                        for (int a = 0; a < 3; a++)
+                        {
+                            if (xyzIndex[a] == j) axis = a;
+                        }
+
+                        if (0 <= axis)
+                        {
+                            if ('+' == *p) p++;
+                            float value = 0.0f;
+                            auto result = std::from_chars(p, lineEnd, value);
+                            if (std::errc() != result.ec)
+                            {
+                                failed = true;
+                                return;
+                            }
+                            xyz[vertex * 3 + axis] = value;
+                            p = result.ptr;
+                        }
+                        else
+                        {
+                            while (p < lineEnd && false == IsBlank(*p)) p++;
+                        }
+                    }
+
+                    vertex++;
+                    p = lineEnd + 1;
+                }
+            }
+        });
+
+    return false == failed;
+}
+
+namespace
+{
+    const char* const PositionNames[3] = { "x", "y", "z" };
+    const char* const NormalNames[3] = { "nx", "ny", "nz" };
+
+    // Converts the three named float or double properties of every vertex record to packed floats
+    bool ParseBinaryTriples(const char* body, size_t bodySize, size_t numberOfVertices,
+        const PLYHeader::Element& vertexElement, const char* const names[3], float* xyz)
+    {
+        size_t stride = 0;
+        size_t offsets[3] = { 0, 0, 0 };
+        bool isDouble[3] = { false, false, false };
+        int found = 0;
+        for (auto& property : vertexElement.properties)
+        {
+            auto size = property.GetTypeSize();
+            if (property.isList || 0 == size)
+                return false;
+
+            for (int axis = 0; axis < 3; axis++)
+            {
+                if (property.name == names[axis])
+                {
+                    if (false == IsFloatType(property.type) && false == IsDoubleType(property.type))
+                        return false;
+                    offsets[axis] = stride;
+                    isDouble[axis] = IsDoubleType(property.type);
+                    found++;
+                }
+            }
+            stride += size;
+        }
+
+        if (3 != found || bodySize < stride * numberOfVertices)
+            return false;
+
+        // The common case is a record of exactly the three floats, which is one contiguous block
+        bool packed = 12 == stride && 0 == offsets[0] && 4 == offsets[1] && 8 == offsets[2] && false == isDouble[0];
+        vtkSMPTools::For(0, (vtkIdType)numberOfVertices, [&](vtkIdType begin, vtkIdType end)
+            {
+                if (packed)
+                {
+                    memcpy(xyz + begin * 3, body + begin * 12, (end - begin) * 12);
+                    return;
+                }
+
+                for (vtkIdType i = begin; i < end; i++)
+                {
+                    auto record = body + i * stride;
+                    for (int axis = 0; axis < 3; axis++)
+                    {
+                        if (isDouble[axis])
+                        {
+                            double value;
+                            memcpy(&value, record + offsets[axis], sizeof(double));
+                            xyz[i * 3 + axis] = (float)value;
+                        }
+                        else
+                        {
+                            memcpy(xyz + i * 3 + axis, record + offsets[axis], sizeof(float));
+                        }
+                    }
+                }
+            });
+
+        return true;
+    }
+}
+
+bool ParseBinaryVertices(const char* body, size_t bodySize, size_t numberOfVertices,
+    const PLYHeader::Element& vertexElement, float* xyz)
+{
+    return ParseBinaryTriples(body, bodySize, numberOfVertices, vertexElement, PositionNames, xyz);
+}
+
+namespace
+{
+    // Fails on indices outside [0, numberOfVertices), which would crash everything downstream of the reader
+    bool ReadBinaryFaces(const char* body, size_t bodySize, const PLYHeader::Element& faceElement, size_t numberOfVertices,
+        vtkCellArray* polys)
+    {
+        if (1 != faceElement.properties.size())
+            return false;
+
+        auto& property = faceElement.properties[0];
+        if (false == property.isList || 1 != PLYHeader::TypeSize(property.countType) || 4 != property.GetTypeSize())
+            return false;
+
+        // Records have variable length, so the offsets are found in one serial pass
+        auto numberOfFaces = faceElement.count;
+        vtkNew<vtkIdTypeArray> offsets;
+        offsets->SetNumberOfTuples((vtkIdType)numberOfFaces + 1);
+        auto offsetPointer = offsets->GetPointer(0);
+
+        vector<size_t> recordOffsets(numberOfFaces);
+        size_t position = 0;
+        vtkIdType connectivitySize = 0;
+        for (size_t f = 0; f < numberOfFaces; f++)
+        {
+            if (bodySize <= position)
+                return false;
+
+            auto count = (unsigned char)body[position];
+            recordOffsets[f] = position + 1;
+            offsetPointer[f] = connectivitySize;
+            connectivitySize += count;
+            position += 1 + (size_t)count * 4;
+        }
+        offsetPointer[numberOfFaces] = connectivitySize;
+        if (bodySize < position)
+            return false;
+
+        vtkNew<vtkIdTypeArray> connectivity;
+        connectivity->SetNumberOfTuples(connectivitySize);
+        auto connectivityPointer = connectivity->GetPointer(0);
+
+        std::atomic<bool> valid(true);
+        vtkSMPTools::For(0, (vtkIdType)numberOfFaces, [&](vtkIdType begin, vtkIdType end)
+            {
+                for (vtkIdType f = begin; f < end; f++)
+                {
+                    auto record = body + recordOffsets[f];
+                    for (vtkIdType k = offsetPointer[f]; k < offsetPointer[f + 1]; k++, record += 4)
+                    {
+                        int32_t index;
+                        memcpy(&index, record, sizeof(int32_t));
+                        if (index < 0 || numberOfVertices <= (size_t)index)
+                        {
+                            valid = false;
+                            return;
+                        }
+                        connectivityPointer[k] = index;
+                    }
+                }
+            });
+        if (false == valid)
+            return false;
+
+        polys->SetData(offsets, connectivity);
+        return true;
+    }
+}
+
+vtkSmartPointer<vtkPolyData> ReadPLYFast(const std::string& filePath)
+{
+    MappedFile file;
+    if (false == file.Open(filePath))
+        return nullptr;
+
+    PLYHeader header;
+    if (false == PLYHeader::Parse(file.GetData(), file.GetSize(), header))
+        return nullptr;
+
+    // A vertex element, optionally followed by a face element in binary files
+    const PLYHeader::Element* vertexElement = nullptr;
+    const PLYHeader::Element* faceElement = nullptr;
+    for (auto& element : header.elements)
+    {
+        if ("vertex" == element.name && nullptr == vertexElement && nullptr == faceElement) vertexElement = &element;
+        else if ("face" == element.name && nullptr != vertexElement && nullptr == faceElement) faceElement = &element;
+        else if (0 != element.count) return nullptr;
+    }
+    if (nullptr == vertexElement || PLYHeader::BinaryBigEndian == header.format)
+        return nullptr;
+    if (nullptr != faceElement && 0 != faceElement->count && PLYHeader::ASCII == header.format)
+        return nullptr;
+
+    // Binary files may add nx ny nz, any other vertex property (colors, ...) is point data only vtkPLYReader loads
+    auto hasNames = [&](const char* const names[3])
+    {
+        return std::all_of(names, names + 3, [&](const char* name)
+            {
+                return 1 == std::count_if(vertexElement->properties.begin(), vertexElement->properties.end(),
+                    [&](const PLYHeader::Property& property) { return name == property.name; });
+            });
+    };
+    bool hasNormals = 6 == vertexElement->properties.size() && PLYHeader::ASCII != header.format && hasNames(NormalNames);
+    if ((false == hasNormals && 3 != vertexElement->properties.size()) || false == hasNames(PositionNames))
+        return nullptr;
+
+    auto numberOfVertices = vertexElement->count;
+
+    vtkNew<vtkPoints> points;
+    points->SetDataTypeToFloat();
+    points->SetNumberOfPoints((vtkIdType)numberOfVertices);
+    auto xyz = vtkFloatArray::FastDownCast(points->GetData())->GetPointer(0);
+
+    auto body = file.GetData() + header.headerSize;
+    auto bodySize = file.GetSize() - header.headerSize;
+
+    auto polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(points);
+
+    if (PLYHeader::ASCII == header.format)
+    {
+        int xyzIndex[3] = { -1, -1, -1 };
+        int numberOfProperties = (int)vertexElement->properties.size();
+        for (int j = 0; j < numberOfProperties; j++)
+        {
+            auto& property = vertexElement->properties[j];
+            if (property.isList) return nullptr;
+            if ("x" == property.name) xyzIndex[0] = j;
+            else if ("y" == property.name) xyzIndex[1] = j;
+            else if ("z" == property.name) xyzIndex[2] = j;
+        }
+        if (xyzIndex[0] < 0 || xyzIndex[1] < 0 || xyzIndex[2] < 0)
+            return nullptr;
+
+        if (false == ParseASCIIVertices(body, body + bodySize, numberOfVertices, numberOfProperties, xyzIndex, xyz))
+            return nullptr;
+    }
+    else
+    {
+        if (false == ParseBinaryVertices(body, bodySize, numberOfVertices, *vertexElement, xyz))
+            return nullptr;
+
+        if (hasNormals)
+        {
+            vtkNew<vtkFloatArray> normals;
+            normals->SetName("Normals");
+            normals->SetNumberOfComponents(3);
+            normals->SetNumberOfTuples((vtkIdType)numberOfVertices);
+            if (false == ParseBinaryTriples(body, bodySize, numberOfVertices, *vertexElement, NormalNames, normals->GetPointer(0)))
+                return nullptr;
+            polyData->GetPointData()->SetNormals(normals);
+        }
+
+        if (nullptr != faceElement && 0 != faceElement->count)
+        {
+            size_t vertexSize = 0;
+            for (auto& property : vertexElement->properties) vertexSize += property.GetTypeSize();
+            auto faceOffset = vertexSize * numberOfVertices;
+
+            vtkNew<vtkCellArray> polys;
+            if (false == ReadBinaryFaces(body + faceOffset, bodySize - faceOffset, *faceElement, numberOfVertices, polys))
+                return nullptr;
+            polyData->SetPolys(polys);
+        }
+    }
+
+    return polyData;
+}
+
+namespace
+{
+    // Packs every polygon as a uchar count followed by int indices.
+    // Cell c starts at byte c + 4 * offsets[c], so all cells are written in parallel.
+    template <typename ArrayT>
+    bool PackFaces(ArrayT* offsetsArray, ArrayT* connectivityArray, vector<char>& buffer)
+    {
+        auto numberOfCells = offsetsArray->GetNumberOfTuples() - 1;
+        auto offsets = offsetsArray->GetPointer(0);
+        auto connectivity = connectivityArray->GetPointer(0);
+
+        for (vtkIdType c = 0; c < numberOfCells; c++)
+        {
+            if (255 < offsets[c + 1] - offsets[c])
+                return false;
+        }
+
+        buffer.resize((size_t)numberOfCells + 4 * (size_t)offsets[numberOfCells]);
+        vtkSMPTools::For(0, numberOfCells, [&](vtkIdType begin, vtkIdType end)
+            {
+                for (vtkIdType c = begin; c < end; c++)
+                {
+                    auto record = buffer.data() + c + 4 * (size_t)offsets[c];
+                    *record++ = (char)(unsigned char)(offsets[c + 1] - offsets[c]);
+                    for (auto k = offsets[c]; k < offsets[c + 1]; k++, record += 4)
+                    {
+                        auto index = (int32_t)connectivity[k];
+                        memcpy(record, &index, sizeof(int32_t));
+                    }
+                }
+            });
+        return true;
+    }
+}
+
+bool WritePLYBinary(vtkPolyData* data, const std::string& filePath)
+{
+    if (nullptr == data || 0 < data->GetNumberOfVerts() || 0 < data->GetNumberOfLines() || 0 < data->GetNumberOfStrips())
+        return false;
+    // Normals become nx ny nz, any other point data is left to vtkPLYWriter
+    auto normals = data->GetPointData()->GetNormals();
+    if (nullptr != normals && (3 != normals->GetNumberOfComponents() || normals->GetNumberOfTuples() != data->GetNumberOfPoints()))
+        return false;
+    if ((nullptr != normals ? 1 : 0) < data->GetPointData()->GetNumberOfArrays())
+        return false;
+
+    auto nop = data->GetNumberOfPoints();
+    auto polys = data->GetPolys();
+    auto numberOfPolys = data->GetNumberOfPolys();
+
+    vector<char> faces;
+    if (0 < numberOfPolys)
+    {
+        bool packed = polys->IsStorage64Bit() ?
+            PackFaces(polys->GetOffsetsArray64(), polys->GetConnectivityArray64(), faces) :
+            PackFaces(polys->GetOffsetsArray32(), polys->GetConnectivityArray32(), faces);
+        if (false == packed)
+            return false;
+    }
+
+    // Points that are not float already are converted once into a temporary block
+    vector<float> converted;
+    const float* xyz = nullptr;
+    auto floatPoints = nullptr != data->GetPoints() ? vtkFloatArray::FastDownCast(data->GetPoints()->GetData()) : nullptr;
+    if (nullptr != floatPoints)
+    {
+        xyz = floatPoints->GetPointer(0);
+    }
+    else if (0 < nop)
+    {
+        converted.resize((size_t)nop * 3);
+        auto points = data->GetPoints();
+        vtkSMPTools::For(0, nop, [&](vtkIdType begin, vtkIdType end)
+            {
+                for (vtkIdType i = begin; i < end; i++)
+                {
+                    double p[3];
+                    points->GetPoint(i, p);
+                    converted[i * 3 + 0] = (float)p[0];
+                    converted[i * 3 + 1] = (float)p[1];
+                    converted[i * 3 + 2] = (float)p[2];
+                }
+            });
+        xyz = converted.data();
+    }
+
+    // With normals every vertex record interleaves the position and the normal
+    vector<float> vertices;
+    if (nullptr != normals && 0 < nop)
+    {
+        vertices.resize((size_t)nop * 6);
+        vtkSMPTools::For(0, nop, [&](vtkIdType begin, vtkIdType end)
+            {
+                for (vtkIdType i = begin; i < end; i++)
+                {
+                    double n[3];
+                    normals->GetTuple(i, n);
+                    for (int axis = 0; axis < 3; axis++)
+                    {
+                        vertices[i * 6 + axis] = xyz[i * 3 + axis];
+                        vertices[i * 6 + 3 + axis] = (float)n[axis];
+                    }
+                }
+            });
+        xyz = vertices.data();
+    }
+    size_t vertexSize = nullptr != normals ? 6 : 3;
+
+    stringstream header;
+    header << "ply\n";
+    header << "format binary_little_endian 1.0\n";
+    header << "element vertex " << nop << "\n";
+    header << "property float x\n";
+    header << "property float y\n";
+    header << "property float z\n";
+    if (nullptr != normals)
+    {
+        header << "property float nx\n";
+        header << "property float ny\n";
+        header << "property float nz\n";
+    }
+    if (0 < numberOfPolys)
+    {
+        header << "element face " << numberOfPolys << "\n";
+        header << "property list uchar int vertex_indices\n";
+    }
+    header << "end_header\n";
+    auto headerString = header.str();
+
+    FILE* fp = fopen(filePath.c_str(), "wb");
+    if (nullptr == fp)
+        return false;
+
+    bool succeeded = headerString.size() == fwrite(headerString.data(), 1, headerString.size(), fp);
+    if (succeeded && 0 < nop)
+    {
+        succeeded = (size_t)nop * vertexSize == fwrite(xyz, sizeof(float), (size_t)nop * vertexSize, fp);
+    }
+    if (succeeded && false == faces.empty())
+    {
+        succeeded = faces.size() == fwrite(faces.data(), 1, faces.size(), fp);
+    }
+
+    succeeded = 0 == fclose(fp) && succeeded;
+    return succeeded;
+}
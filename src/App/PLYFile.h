@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Common.h>
+
+struct PLYHeader
+{
+    enum Format { ASCII, BinaryLittleEndian, BinaryBigEndian };
+
+    struct Property
+    {
+        string name;
+        string type;
+        bool isList = false;
+        string countType;
+
+        // Size in bytes of the scalar type, 0 for unknown types
+        size_t GetTypeSize() const { return TypeSize(type); }
+    };
+
+    struct Element
+    {
+        string name;
+        size_t count = 0;
+        vector<Property> properties;
+    };
+
+    Format format = ASCII;
+    vector<Element> elements;
+    // Bytes up to and including the end_header line
+    size_t headerSize = 0;
+
+    static bool Parse(const char* data, size_t size, PLYHeader& header);
+    static size_t TypeSize(const string& type);
+};
+
+// Reads point-only ASCII files and binary little-endian files with triangle/polygon faces straight into
+// float points and cell arrays. Vertices must have exactly the x y z properties, binary ones may add nx ny nz as Normals.
+// Returns nullptr for layouts it does not handle, ReadPLY then falls back to vtkPLYReader.
+vtkSmartPointer<vtkPolyData> ReadPLYFast(const std::string& filePath);
+
+// Writes points as float x y z, Normals as float nx ny nz and polygons as uchar/int lists in binary little-endian,
+// one fwrite per element. Returns false for polydata with verts, lines, strips or point data arrays besides Normals,
+// which the format written here cannot hold, WritePLY then falls back to vtkPLYWriter.
+bool WritePLYBinary(vtkPolyData* data, const std::string& filePath);
+
+// Parses the ASCII vertex lines in [begin, end) on several threads, one vertex per non-empty line.
+// Only the properties at xyzIndex are converted, the others are skipped.
+bool ParseASCIIVertices(const char* begin, const char* end, size_t numberOfVertices,
+    int numberOfProperties, const int xyzIndex[3], float* xyz);
+
+// Converts numberOfVertices binary little-endian vertex records to float x y z on several threads.
+// Fails when x, y or z is missing or is not a float or double property.
+bool ParseBinaryVertices(const char* body, size_t bodySize, size_t numberOfVertices,
+    const PLYHeader::Element& vertexElement, float* xyz);
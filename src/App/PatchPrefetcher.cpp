@@ -0,0 +1,139 @@
+#include <App/PatchPrefetcher.h>
+#include <App/Utility.h>
+
+#include <filesystem>
+#include <tuple>
+
+PatchPrefetcher::PatchPrefetcher(const vector<string>& filePaths, size_t capacity, size_t numberOfThreads, Loader loader)
+    : filePaths(filePaths), capacity(std::max<size_t>(capacity, 1)), loader(loader)
+{
+    if (nullptr == this->loader)
+    {
+        this->loader = [](const std::string& filePath) { return ReadPLY(filePath); };
+    }
+
+    numberOfThreads = std::clamp<size_t>(numberOfThreads, 1, this->capacity);
+    for (size_t i = 0; i < numberOfThreads; i++)
+    {
+        workers.emplace_back(&PatchPrefetcher::Work, this);
+    }
+}
+
+PatchPrefetcher::~PatchPrefetcher()
+{
+    Stop();
+}
+
+void PatchPrefetcher::Work()
+{
+    while (true)
+    {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // A slot is taken from the moment a worker claims an index until the consumer takes the patch
+            spaceCondition.wait(lock, [&] { return stopped || nextToLoad < nextToHand + capacity; });
+            if (stopped || filePaths.size() <= nextToLoad)
+                return;
+
+            index = nextToLoad++;
+        }
+
+        Patch patch;
+        patch.index = index;
+        patch.filePath = filePaths[index];
+
+        auto beginTime = chrono::steady_clock::now();
+        // An exception leaving the worker thread would terminate the process
+        try
+        {
+            patch.data = loader(patch.filePath);
+        }
+        catch (...)
+        {
+            patch.data = nullptr;
+            patch.error = std::current_exception();
+        }
+        patch.loadMiliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - beginTime).count();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            loaded[index] = std::move(patch);
+        }
+        loadedCondition.notify_all();
+    }
+}
+
+bool PatchPrefetcher::Next(Patch& patch)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (stopped || filePaths.size() <= nextToHand)
+        return false;
+
+    auto beginTime = chrono::steady_clock::now();
+    loadedCondition.wait(lock, [&] { return stopped || loaded.count(nextToHand); });
+    waitMiliseconds += chrono::duration<double, milli>(chrono::steady_clock::now() - beginTime).count();
+    if (stopped)
+        return false;
+
+    auto it = loaded.find(nextToHand);
+    patch = std::move(it->second);
+    loaded.erase(it);
+    nextToHand++;
+
+    lock.unlock();
+    spaceCondition.notify_all();
+    return true;
+}
+
+void PatchPrefetcher::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    spaceCondition.notify_all();
+    loadedCondition.notify_all();
+
+    for (auto& worker : workers)
+    {
+        if (worker.joinable()) worker.join();
+    }
+    workers.clear();
+}
+
+vector<string> PatchPrefetcher::ListPatches(const string& directory, const string& extension)
+{
+    vector<std::filesystem::path> files;
+    std::error_code error;
+    for (auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        if (entry.is_regular_file() && extension == entry.path().extension())
+        {
+            files.push_back(entry.path());
+        }
+    }
+
+    auto isNumber = [](const string& s)
+    {
+        return false == s.empty() && std::all_of(s.begin(), s.end(), [](char c) { return '0' <= c && c <= '9'; });
+    };
+
+    // Numeric stems come first, shorter before longer so "9" precedes "10", then everything by path.
+    // Comparing one key per file keeps the order a strict weak ordering when both kinds are mixed
+    auto sortKey = [&](const std::filesystem::path& path)
+    {
+        auto stem = path.stem().string();
+        auto numeric = isNumber(stem);
+        return std::make_tuple(false == numeric, numeric ? stem.size() : (size_t)0, std::cref(path));
+    };
+    std::sort(files.begin(), files.end(), [&](const std::filesystem::path& a, const std::filesystem::path& b)
+        {
+            return sortKey(a) < sortKey(b);
+        });
+
+    vector<string> result;
+    result.reserve(files.size());
+    for (auto& file : files) result.push_back(file.string());
+    return result;
+}
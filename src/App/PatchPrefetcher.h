@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Common.h>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+struct Patch
+{
+    size_t index = 0;
+    string filePath;
+    // nullptr when the file could not be read
+    vtkSmartPointer<vtkPolyData> data;
+    // What the loader threw, data is nullptr then. Rethrow it with std::rethrow_exception
+    std::exception_ptr error;
+    double loadMiliseconds = 0.0;
+};
+
+// Loads patches on background threads ahead of the consumer.
+// At most capacity patches are in flight or waiting, workers block until the consumer takes one (back-pressure),
+// and Next hands them out in the order of the input list whatever order they finish loading in.
+class PatchPrefetcher
+{
+public:
+    using Loader = std::function<vtkSmartPointer<vtkPolyData>(const std::string&)>;
+
+    PatchPrefetcher(const vector<string>& filePaths, size_t capacity = 4, size_t numberOfThreads = 2, Loader loader = nullptr);
+    ~PatchPrefetcher();
+
+    PatchPrefetcher(const PatchPrefetcher&) = delete;
+    PatchPrefetcher& operator=(const PatchPrefetcher&) = delete;
+
+    // Blocks until the next patch is loaded, returns false once every patch has been handed out or after Stop.
+    // A loader that throws does not stop the workers, its patch comes out with the exception in error.
+    bool Next(Patch& patch);
+
+    // Wakes up the consumer and the workers and joins the workers. Patches not yet handed out are dropped.
+    void Stop();
+
+    inline size_t GetNumberOfPatches() const { return filePaths.size(); }
+    // Total time Next spent waiting on a patch that was not loaded yet
+    inline double GetWaitMiliseconds() const { return waitMiliseconds; }
+
+    // Sorted .ply files of a directory, numerically when the file names are numbers (0.ply, 1.ply, ... 10.ply)
+    static vector<string> ListPatches(const string& directory, const string& extension = ".ply");
+
+private:
+    vector<string> filePaths;
+    size_t capacity;
+    Loader loader;
+
+    std::mutex mutex;
+    std::condition_variable loadedCondition;
+    std::condition_variable spaceCondition;
+    map<size_t, Patch> loaded;
+    size_t nextToLoad = 0;
+    size_t nextToHand = 0;
+    bool stopped = false;
+    double waitMiliseconds = 0.0;
+
+    vector<std::thread> workers;
+
+    void Work();
+};
@@ -0,0 +1,247 @@
+#include <App/PointArchive.h>
+#include <Algorithm/Morton.h>
+
+#include <zstd.h>
+#include <atomic>
+#include <cstring>
+
+namespace
+{
+    inline void WriteVarint(uint64_t value, vector<unsigned char>& buffer)
+    {
+        while (0x80 <= value)
+        {
+            buffer.push_back((unsigned char)(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back((unsigned char)value);
+    }
+
+    inline bool ReadVarint(const unsigned char*& p, const unsigned char* end, uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; p < end && shift < 64; shift += 7)
+        {
+            auto byte = *p++;
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            if (0 == (byte & 0x80)) return true;
+        }
+        return false;
+    }
+}
+
+bool WritePointArchive(vtkPolyData* data, const std::string& filePath,
+    int bitsPerAxis, uint32_t pointsPerBlock, int compressionLevel)
+{
+    if (nullptr == data || nullptr == data->GetPoints() || bitsPerAxis < 1 || 21 < bitsPerAxis || 0 == pointsPerBlock)
+        return false;
+
+    auto points = data->GetPoints();
+    auto nop = points->GetNumberOfPoints();
+
+    PointArchiveHeader header;
+    header.bitsPerAxis = (uint32_t)bitsPerAxis;
+    header.pointsPerBlock = pointsPerBlock;
+    header.numberOfPoints = (uint64_t)nop;
+    header.numberOfBlocks = (header.numberOfPoints + pointsPerBlock - 1) / pointsPerBlock;
+
+    double bounds[6];
+    points->GetBounds(bounds);
+    auto maximumValue = (double)((1u << bitsPerAxis) - 1);
+    for (int axis = 0; axis < 3; axis++)
+    {
+        auto extent = bounds[axis * 2 + 1] - bounds[axis * 2];
+        header.boundsMin[axis] = bounds[axis * 2];
+        header.cellSize[axis] = 0.0 < extent ? extent / maximumValue : 1.0;
+    }
+
+    vector<uint64_t> codes(nop);
+    vtkSMPTools::For(0, nop, [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                double p[3];
+                points->GetPoint(i, p);
+
+                uint32_t q[3];
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    auto value = std::round((p[axis] - header.boundsMin[axis]) / header.cellSize[axis]);
+                    q[axis] = (uint32_t)std::clamp(value, 0.0, maximumValue);
+                }
+                codes[i] = EncodeMorton(q[0], q[1], q[2]);
+            }
+        });
+
+    vtkSMPTools::Sort(codes.begin(), codes.end());
+
+    // Every block restarts its delta chain, so blocks never depend on each other
+    vector<PointArchiveBlock> blocks(header.numberOfBlocks);
+    vector<vector<char>> compressed(header.numberOfBlocks);
+    std::atomic<bool> failed(false);
+    vtkSMPTools::For(0, (vtkIdType)header.numberOfBlocks, [&](vtkIdType begin, vtkIdType end)
+        {
+            vector<unsigned char> encoded;
+            for (vtkIdType b = begin; b < end; b++)
+            {
+                auto first = (size_t)b * pointsPerBlock;
+                auto last = std::min(first + pointsPerBlock, (size_t)nop);
+
+                encoded.clear();
+                uint64_t previous = 0;
+                for (auto i = first; i < last; i++)
+                {
+                    WriteVarint(codes[i] - previous, encoded);
+                    previous = codes[i];
+                }
+
+                auto& output = compressed[b];
+                output.resize(ZSTD_compressBound(encoded.size()));
+                auto size = ZSTD_compress(output.data(), output.size(), encoded.data(), encoded.size(), compressionLevel);
+                if (ZSTD_isError(size))
+                {
+                    failed = true;
+                    return;
+                }
+                output.resize(size);
+
+                blocks[b].compressedSize = size;
+                blocks[b].encodedSize = encoded.size();
+                blocks[b].numberOfPoints = (uint32_t)(last - first);
+            }
+        });
+    if (failed)
+        return false;
+
+    uint64_t offset = sizeof(PointArchiveHeader) + sizeof(PointArchiveBlock) * blocks.size();
+    for (auto& block : blocks)
+    {
+        block.offset = offset;
+        offset += block.compressedSize;
+    }
+
+    FILE* fp = fopen(filePath.c_str(), "wb");
+    if (nullptr == fp)
+        return false;
+
+    bool succeeded = 1 == fwrite(&header, sizeof(PointArchiveHeader), 1, fp);
+    if (succeeded && false == blocks.empty())
+    {
+        succeeded = blocks.size() == fwrite(blocks.data(), sizeof(PointArchiveBlock), blocks.size(), fp);
+    }
+    for (size_t b = 0; succeeded && b < compressed.size(); b++)
+    {
+        succeeded = compressed[b].size() == fwrite(compressed[b].data(), 1, compressed[b].size(), fp);
+    }
+
+    succeeded = 0 == fclose(fp) && succeeded;
+    return succeeded;
+}
+
+bool PointArchiveReader::Open(const std::string& filePath)
+{
+    blocks.clear();
+    if (false == file.Open(filePath) || file.GetSize() < sizeof(PointArchiveHeader))
+        return false;
+
+    memcpy(&header, file.GetData(), sizeof(PointArchiveHeader));
+    if (0 != memcmp(header.magic, "SVOP", 4) || 1 != header.version
+        || header.bitsPerAxis < 1 || 21 < header.bitsPerAxis || 0 == header.pointsPerBlock)
+        return false;
+
+    // The block table is checked before it is sized from, so a corrupt count cannot make it overflow
+    auto fileSize = (uint64_t)file.GetSize();
+    if ((fileSize - sizeof(PointArchiveHeader)) / sizeof(PointArchiveBlock) < header.numberOfBlocks
+        || header.numberOfBlocks != (header.numberOfPoints + header.pointsPerBlock - 1) / header.pointsPerBlock)
+        return false;
+
+    auto tableSize = sizeof(PointArchiveBlock) * header.numberOfBlocks;
+    blocks.resize(header.numberOfBlocks);
+    memcpy(blocks.data(), file.GetData() + sizeof(PointArchiveHeader), tableSize);
+
+    // ReadAll decodes block b at point b * pointsPerBlock, so every block but the last has to be full
+    // and the counts have to add up to the header total
+    uint64_t numberOfPoints = 0;
+    for (size_t b = 0; b < blocks.size(); b++)
+    {
+        auto& block = blocks[b];
+        bool last = b + 1 == blocks.size();
+        if (block.compressedSize > fileSize || block.offset > fileSize - block.compressedSize
+            || block.numberOfPoints > header.pointsPerBlock || (false == last && block.numberOfPoints != header.pointsPerBlock)
+            // A varint takes 1 to 10 bytes
+            || block.encodedSize < block.numberOfPoints || block.encodedSize > (uint64_t)block.numberOfPoints * 10)
+        {
+            blocks.clear();
+            return false;
+        }
+        numberOfPoints += block.numberOfPoints;
+    }
+    if (numberOfPoints != header.numberOfPoints)
+    {
+        blocks.clear();
+        return false;
+    }
+    return true;
+}
+
+double PointArchiveReader::GetMaximumError() const
+{
+    return 0.5 * std::max({ header.cellSize[0], header.cellSize[1], header.cellSize[2] });
+}
+
+bool PointArchiveReader::ReadBlock(size_t index, float* xyz) const
+{
+    if (blocks.size() <= index)
+        return false;
+
+    auto& block = blocks[index];
+
+    vector<unsigned char> encoded(block.encodedSize);
+    auto size = ZSTD_decompress(encoded.data(), encoded.size(), file.GetData() + block.offset, block.compressedSize);
+    if (ZSTD_isError(size) || size != block.encodedSize)
+        return false;
+
+    // The varint stream has to hold exactly the block's points
+    auto p = (const unsigned char*)encoded.data();
+    auto end = p + encoded.size();
+    uint64_t code = 0;
+    for (uint32_t i = 0; i < block.numberOfPoints; i++)
+    {
+        uint64_t delta;
+        if (false == ReadVarint(p, end, delta))
+            return false;
+        code += delta;
+
+        uint32_t q[3];
+        DecodeMorton(code, q[0], q[1], q[2]);
+        for (int axis = 0; axis < 3; axis++)
+        {
+            xyz[i * 3 + axis] = (float)(header.boundsMin[axis] + (double)q[axis] * header.cellSize[axis]);
+        }
+    }
+    return p == end;
+}
+
+vtkSmartPointer<vtkPolyData> PointArchiveReader::ReadAll() const
+{
+    vtkNew<vtkPoints> points;
+    points->SetDataTypeToFloat();
+    points->SetNumberOfPoints((vtkIdType)header.numberOfPoints);
+    auto xyz = vtkFloatArray::FastDownCast(points->GetData())->GetPointer(0);
+
+    std::atomic<bool> failed(false);
+    vtkSMPTools::For(0, (vtkIdType)blocks.size(), [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType b = begin; b < end; b++)
+            {
+                if (false == ReadBlock((size_t)b, xyz + (size_t)b * header.pointsPerBlock * 3))
+                    failed = true;
+            }
+        });
+    if (failed)
+        return nullptr;
+
+    auto polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(points);
+    return polyData;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Common.h>
+#include <App/MappedFile.h>
+
+// Compact point cloud file for archiving scans.
+// Coordinates are quantized to bitsPerAxis (up to 21) against the bounding box, sorted in Morton order,
+// delta-encoded as varints and compressed with zstd in independent blocks. Every block can be decoded on
+// its own, so a reader can seek to one block or decode all of them in parallel.
+// Points come back in Morton order, each coordinate within half a cell of the original.
+
+struct PointArchiveHeader
+{
+    char magic[4] = { 'S', 'V', 'O', 'P' };
+    uint32_t version = 1;
+    uint32_t bitsPerAxis = 16;
+    uint32_t pointsPerBlock = 65536;
+    uint64_t numberOfPoints = 0;
+    uint64_t numberOfBlocks = 0;
+    double boundsMin[3] = { 0.0, 0.0, 0.0 };
+    double cellSize[3] = { 1.0, 1.0, 1.0 };
+};
+
+struct PointArchiveBlock
+{
+    uint64_t offset = 0;
+    uint64_t compressedSize = 0;
+    uint64_t encodedSize = 0;
+    uint32_t numberOfPoints = 0;
+    uint32_t reserved = 0;
+};
+
+bool WritePointArchive(vtkPolyData* data, const std::string& filePath,
+    int bitsPerAxis = 16, uint32_t pointsPerBlock = 65536, int compressionLevel = 3);
+
+class PointArchiveReader
+{
+public:
+    bool Open(const std::string& filePath);
+
+    inline const PointArchiveHeader& GetHeader() const { return header; }
+    inline size_t GetNumberOfBlocks() const { return blocks.size(); }
+    inline const PointArchiveBlock& GetBlock(size_t index) const { return blocks[index]; }
+
+    // Largest per-axis distance between a stored and an original coordinate
+    double GetMaximumError() const;
+
+    // Decodes one block into xyz, which must hold 3 * GetBlock(index).numberOfPoints floats
+    bool ReadBlock(size_t index, float* xyz) const;
+
+    // Decodes all blocks in parallel
+    vtkSmartPointer<vtkPolyData> ReadAll() const;
+
+private:
+    PointArchiveHeader header;
+    vector<PointArchiveBlock> blocks;
+    MappedFile file;
+};
@@ -0,0 +1,242 @@
+#include <App/PointStreamReader.h>
+
+#include <cstring>
+
+namespace
+{
+    inline bool IsBlank(char c)
+    {
+        return ' ' == c || '\t' == c || '\r' == c;
+    }
+
+    // Counts down the non-empty lines of [begin, end) and returns the position right after the one that brings count to 0.
+    // Returns nullptr when there are not enough lines, lastBreak is then right after the last complete line.
+    const char* FindLinesEnd(const char* begin, const char* end, size_t& count, const char*& lastBreak)
+    {
+        bool hasContent = false;
+        lastBreak = begin;
+        for (auto p = begin; p < end; p++)
+        {
+            if ('\n' == *p)
+            {
+                if (hasContent && 0 == --count) return p + 1;
+                hasContent = false;
+                lastBreak = p + 1;
+            }
+            else if (false == IsBlank(*p))
+            {
+                hasContent = true;
+            }
+        }
+        return nullptr;
+    }
+}
+
+bool PointStreamReader::Open(const std::string& filePath, size_t pointsPerChunk, size_t maxChunksInMemory)
+{
+    Close();
+
+    file = fopen(filePath.c_str(), "rb");
+    if (nullptr == file)
+        return false;
+
+    // The header is parsed from a prefix of the file, then reading restarts right after it
+    vector<char> prefix(1 << 16);
+    prefix.resize(fread(prefix.data(), 1, prefix.size(), file));
+    if (false == PLYHeader::Parse(prefix.data(), prefix.size(), header) || PLYHeader::BinaryBigEndian == header.format)
+    {
+        Close();
+        return false;
+    }
+
+    // Vertices have to come first, whatever follows them is never read
+    for (auto& element : header.elements)
+    {
+        if ("vertex" == element.name)
+        {
+            vertexElement = &element;
+            break;
+        }
+        if (0 != element.count)
+            break;
+    }
+    if (nullptr == vertexElement)
+    {
+        Close();
+        return false;
+    }
+
+    recordSize = 0;
+    for (int j = 0; j < (int)vertexElement->properties.size(); j++)
+    {
+        auto& property = vertexElement->properties[j];
+        if (property.isList) break;
+        if ("x" == property.name) xyzIndex[0] = j;
+        else if ("y" == property.name) xyzIndex[1] = j;
+        else if ("z" == property.name) xyzIndex[2] = j;
+        recordSize += property.GetTypeSize();
+    }
+    if (xyzIndex[0] < 0 || xyzIndex[1] < 0 || xyzIndex[2] < 0)
+    {
+        Close();
+        return false;
+    }
+
+    if (PLYHeader::ASCII == header.format)
+    {
+        pending.assign(prefix.begin() + header.headerSize, prefix.end());
+    }
+    else
+    {
+        fseek(file, (long)header.headerSize, SEEK_SET);
+    }
+
+    numberOfPoints = vertexElement->count;
+    this->pointsPerChunk = std::max<size_t>(pointsPerChunk, 1);
+    this->maxChunksInMemory = std::max<size_t>(maxChunksInMemory, 1);
+    finished = false;
+    stopped = false;
+    failed = false;
+
+    producer = std::thread(&PointStreamReader::Produce, this);
+    return true;
+}
+
+void PointStreamReader::Close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    spaceCondition.notify_all();
+    if (producer.joinable()) producer.join();
+
+    if (nullptr != file)
+    {
+        fclose(file);
+        file = nullptr;
+    }
+
+    header = PLYHeader();
+    vertexElement = nullptr;
+    numberOfPoints = 0;
+    pending.clear();
+    pending.shrink_to_fit();
+    xyzIndex[0] = xyzIndex[1] = xyzIndex[2] = -1;
+    ready.clear();
+    freeBuffers.clear();
+}
+
+void PointStreamReader::Produce()
+{
+    size_t index = 0;
+    for (size_t firstPoint = 0; firstPoint < numberOfPoints; firstPoint += pointsPerChunk, index++)
+    {
+        PointChunk chunk;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            spaceCondition.wait(lock, [&] { return stopped || ready.size() < maxChunksInMemory; });
+            if (stopped)
+                return;
+
+            if (false == freeBuffers.empty())
+            {
+                chunk.xyz.swap(freeBuffers.back());
+                freeBuffers.pop_back();
+            }
+        }
+
+        auto count = std::min(pointsPerChunk, numberOfPoints - firstPoint);
+        chunk.index = index;
+        chunk.firstPoint = firstPoint;
+        chunk.xyz.resize(count * 3);
+
+        bool succeeded = PLYHeader::ASCII == header.format
+            ? ReadASCIIChunk(count, chunk.xyz.data())
+            : ReadBinaryChunk(count, chunk.xyz.data());
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (false == succeeded)
+            {
+                failed = true;
+                break;
+            }
+            ready.push_back(std::move(chunk));
+        }
+        readyCondition.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    readyCondition.notify_all();
+}
+
+bool PointStreamReader::ReadASCIIChunk(size_t count, float* xyz)
+{
+    // Lines are read in blocks until count of them are buffered, the remainder stays pending for the next chunk
+    const size_t blockSize = 1 << 20;
+    size_t remaining = count;
+    size_t scanned = 0;
+    bool atEnd = false;
+    while (true)
+    {
+        const char* lastBreak = nullptr;
+        auto linesEnd = FindLinesEnd(pending.data() + scanned, pending.data() + pending.size(), remaining, lastBreak);
+        if (nullptr != linesEnd)
+        {
+            if (false == ParseASCIIVertices(pending.data(), linesEnd, count, (int)vertexElement->properties.size(), xyzIndex, xyz))
+                return false;
+
+            pending.erase(pending.begin(), pending.begin() + (linesEnd - pending.data()));
+            return true;
+        }
+        if (atEnd)
+            return false;
+
+        // A partial last line is scanned again once the rest of it has been read
+        scanned = (size_t)(lastBreak - pending.data());
+
+        auto size = pending.size();
+        pending.resize(size + blockSize);
+        auto read = fread(pending.data() + size, 1, blockSize, file);
+        pending.resize(size + read);
+        if (0 == read)
+        {
+            // The last line may lack its line break
+            pending.push_back('\n');
+            atEnd = true;
+        }
+    }
+}
+
+bool PointStreamReader::ReadBinaryChunk(size_t count, float* xyz)
+{
+    // Reuses the ASCII line buffer as the record buffer
+    pending.resize(count * recordSize);
+    if (pending.size() != fread(pending.data(), 1, pending.size(), file))
+        return false;
+
+    return ParseBinaryVertices(pending.data(), pending.size(), count, *vertexElement, xyz);
+}
+
+bool PointStreamReader::Next(PointChunk& chunk)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    readyCondition.wait(lock, [&] { return stopped || finished || false == ready.empty(); });
+    if (ready.empty())
+        return false;
+
+    if (0 != chunk.xyz.capacity() && freeBuffers.size() < maxChunksInMemory)
+    {
+        freeBuffers.push_back(std::move(chunk.xyz));
+    }
+    chunk = std::move(ready.front());
+    ready.pop_front();
+
+    lock.unlock();
+    spaceCondition.notify_all();
+    return true;
+}
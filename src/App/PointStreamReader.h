@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Common.h>
+#include <App/PLYFile.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+struct PointChunk
+{
+    size_t index = 0;
+    // Index of the first point of the chunk in the file
+    size_t firstPoint = 0;
+    vector<float> xyz;
+
+    inline size_t GetNumberOfPoints() const { return xyz.size() / 3; }
+};
+
+// Reads the vertices of an ASCII or binary little-endian PLY file as float x y z chunks of pointsPerChunk points.
+// A background thread reads ahead, but never more than maxChunksInMemory chunks wait for the consumer, and
+// the buffers the consumer hands back through Next are reused, so memory stays flat whatever the file size.
+class PointStreamReader
+{
+public:
+    PointStreamReader() {}
+    ~PointStreamReader() { Close(); }
+
+    PointStreamReader(const PointStreamReader&) = delete;
+    PointStreamReader& operator=(const PointStreamReader&) = delete;
+
+    bool Open(const std::string& filePath, size_t pointsPerChunk = 1 << 20, size_t maxChunksInMemory = 2);
+    void Close();
+
+    // Replaces chunk with the next one and recycles its buffer. Returns false at the end of the file or on a read error.
+    bool Next(PointChunk& chunk);
+
+    inline bool HasFailed() const { return failed; }
+    inline size_t GetNumberOfPoints() const { return numberOfPoints; }
+    inline size_t GetPointsPerChunk() const { return pointsPerChunk; }
+    inline size_t GetNumberOfChunks() const { return (numberOfPoints + pointsPerChunk - 1) / pointsPerChunk; }
+
+private:
+    FILE* file = nullptr;
+    PLYHeader header;
+    const PLYHeader::Element* vertexElement = nullptr;
+    size_t numberOfPoints = 0;
+    size_t pointsPerChunk = 0;
+    size_t maxChunksInMemory = 0;
+
+    // ASCII lines that were read but belong to the next chunk
+    vector<char> pending;
+    int xyzIndex[3] = { -1, -1, -1 };
+    size_t recordSize = 0;
+
+    std::thread producer;
+    std::mutex mutex;
+    std::condition_variable readyCondition;
+    std::condition_variable spaceCondition;
+    std::deque<PointChunk> ready;
+    vector<vector<float>> freeBuffers;
+    bool finished = false;
+    bool stopped = false;
+    // Written by the producer, read by HasFailed without the lock
+    std::atomic<bool> failed{ false };
+
+    void Produce();
+    bool ReadASCIIChunk(size_t count, float* xyz);
+    bool ReadBinaryChunk(size_t count, float* xyz);
+};
@@ -0,0 +1,290 @@
+#include <App/StageCache.h>
+#include <App/MappedFile.h>
+
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+namespace
+{
+    const uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+    const uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+
+    inline uint64_t RotateLeft(uint64_t x, int r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    // Final avalanche of splitmix64
+    inline uint64_t Mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ull;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBull;
+        x ^= x >> 31;
+        return x;
+    }
+
+    const char* const EntryDirectory = "stages";
+
+    // Reads the 16 hex digit key at the start of an entry or temporary name
+    bool IsKey(const string& fileName)
+    {
+        if (fileName.size() < 16)
+            return false;
+        return std::all_of(fileName.begin(), fileName.begin() + 16, [](char c) { return 0 != isxdigit((unsigned char)c); });
+    }
+
+    bool IsEntryExtension(const string& extension)
+    {
+        return ".ply" == extension || ".vdb" == extension;
+    }
+
+    // <key><ext>
+    bool IsEntryName(const string& fileName)
+    {
+        return 20 == fileName.size() && IsKey(fileName) && IsEntryExtension(fileName.substr(16));
+    }
+
+    // <key>.tmp<N><ext>, left behind by an interrupted Store
+    bool IsTemporaryName(const string& fileName)
+    {
+        if (fileName.size() < 25 || false == IsKey(fileName) || 0 != fileName.compare(16, 4, ".tmp"))
+            return false;
+        auto extension = fileName.size() - 4;
+        return IsEntryExtension(fileName.substr(extension)) &&
+            std::all_of(fileName.begin() + 20, fileName.begin() + extension, [](char c) { return 0 != isdigit((unsigned char)c); });
+    }
+}
+
+StageHash& StageHash::Add(const void* data, size_t size)
+{
+    auto p = (const unsigned char*)data;
+    auto end = p + size;
+    for (; p + 8 <= end; p += 8)
+    {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        state = RotateLeft(state ^ (word * Prime2), 31) * Prime1;
+    }
+    if (p < end)
+    {
+        uint64_t word = 0;
+        memcpy(&word, p, end - p);
+        state = RotateLeft(state ^ (word * Prime2), 31) * Prime1;
+    }
+    length += size;
+    return *this;
+}
+
+bool StageHash::AddFile(const string& filePath)
+{
+    MappedFile file;
+    if (false == file.Open(filePath))
+        return false;
+
+    Add(file.GetData(), file.GetSize());
+    return true;
+}
+
+uint64_t StageHash::Get() const
+{
+    return Mix(state ^ Mix(length));
+}
+
+StageCache::StageCache(const string& directory, uint64_t maximumBytes)
+    : directory((std::filesystem::path(directory) / EntryDirectory).string()), maximumBytes(maximumBytes)
+{
+    // Entries live in a subdirectory of their own and only files named like them are touched,
+    // so pointing the cache at a directory with other contents is harmless
+    std::error_code error;
+    std::filesystem::create_directories(this->directory, error);
+
+    // Entries of earlier runs, ordered by their last use
+    vector<pair<std::filesystem::file_time_type, Entry>> found;
+    for (auto& item : std::filesystem::directory_iterator(this->directory, error))
+    {
+        if (false == item.is_regular_file())
+            continue;
+
+        auto fileName = item.path().filename().string();
+        if (IsTemporaryName(fileName))
+        {
+            std::filesystem::remove(item.path(), error);
+            continue;
+        }
+        if (false == IsEntryName(fileName))
+            continue;
+
+        Entry entry;
+        entry.fileName = fileName;
+        entry.size = (uint64_t)item.file_size(error);
+        found.push_back({ item.last_write_time(error), entry });
+    }
+
+    std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (auto& item : found)
+    {
+        recency.push_back(item.second.fileName);
+        item.second.recency = std::prev(recency.end());
+        statistics.numberOfBytes += item.second.size;
+        entries[item.second.fileName] = item.second;
+    }
+    statistics.numberOfEntries = entries.size();
+
+    Evict();
+}
+
+string StageCache::FileName(uint64_t key, const string& extension)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+    return string(name) + extension;
+}
+
+void StageCache::Touch(Entry& entry)
+{
+    recency.splice(recency.begin(), recency, entry.recency);
+
+    std::error_code error;
+    std::filesystem::last_write_time(std::filesystem::path(directory) / entry.fileName,
+        std::filesystem::file_time_type::clock::now(), error);
+}
+
+void StageCache::Evict()
+{
+    std::error_code error;
+    auto it = recency.end();
+    while (maximumBytes < statistics.numberOfBytes && recency.begin() != it)
+    {
+        --it;
+        auto entry = entries.find(*it);
+        if (0 < entry->second.pins)
+            continue;
+
+        // A file still open elsewhere cannot be removed on Windows, it stays an entry for a later attempt
+        if (false == std::filesystem::remove(std::filesystem::path(directory) / *it, error) && error)
+            continue;
+
+        statistics.numberOfBytes -= entry->second.size;
+        entries.erase(entry);
+        it = recency.erase(it);
+        statistics.evictions++;
+    }
+    statistics.numberOfEntries = entries.size();
+}
+
+bool StageCache::Load(uint64_t key, const string& extension, const FileFunction& reader, bool pin)
+{
+    auto fileName = FileName(key, extension);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(fileName);
+        if (entries.end() == it)
+        {
+            statistics.misses++;
+            return false;
+        }
+        Touch(it->second);
+        // Pinned before reading, so the file cannot go away halfway
+        if (pin)
+            it->second.pins++;
+    }
+
+    if (reader((std::filesystem::path(directory) / fileName).string()))
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        statistics.hits++;
+        return true;
+    }
+
+    // An unreadable entry is dropped so the stage output replaces it, unless another reader still holds it
+    std::lock_guard<std::mutex> lock(mutex);
+    statistics.misses++;
+    auto it = entries.find(fileName);
+    if (entries.end() == it)
+        return false;
+    if (pin)
+        it->second.pins--;
+    if (0 < it->second.pins)
+        return false;
+
+    std::error_code error;
+    if (false == std::filesystem::remove(std::filesystem::path(directory) / fileName, error) && error)
+        return false;
+
+    statistics.numberOfBytes -= it->second.size;
+    recency.erase(it->second.recency);
+    entries.erase(it);
+    statistics.numberOfEntries = entries.size();
+    return false;
+}
+
+void StageCache::Release(uint64_t key, const string& extension)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(FileName(key, extension));
+    if (entries.end() == it || 0 == it->second.pins)
+        return;
+
+    // Insertions made while the entry was pinned may have left the cache over its size
+    it->second.pins--;
+    Evict();
+}
+
+bool StageCache::Store(uint64_t key, const string& extension, const FileFunction& writer)
+{
+    static std::atomic<uint64_t> temporaryIndex(0);
+
+    auto fileName = FileName(key, extension);
+    auto path = std::filesystem::path(directory) / fileName;
+    // The extension stays last so writers that look at it still work
+    auto temporaryPath = std::filesystem::path(directory) /
+        (FileName(key, ".tmp" + std::to_string(temporaryIndex++)) + extension);
+
+    std::error_code error;
+    if (false == writer(temporaryPath.string()))
+    {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    auto size = (uint64_t)std::filesystem::file_size(temporaryPath, error);
+    if (error)
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    auto it = entries.find(fileName);
+    if (entries.end() != it)
+    {
+        statistics.numberOfBytes -= it->second.size;
+        it->second.size = size;
+        recency.splice(recency.begin(), recency, it->second.recency);
+    }
+    else
+    {
+        recency.push_front(fileName);
+        entries[fileName] = { fileName, size, recency.begin() };
+    }
+    statistics.numberOfBytes += size;
+    statistics.insertions++;
+
+    Evict();
+    return true;
+}
+
+StageCacheStatistics StageCache::GetStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return statistics;
+}
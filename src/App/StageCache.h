@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Common.h>
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+// Non-cryptographic 64-bit hash of stage inputs and parameters, fed eight bytes at a time.
+class StageHash
+{
+public:
+    StageHash(uint64_t seed = 0) : state(seed ^ 0x9E3779B97F4A7C15ull) {}
+
+    StageHash& Add(const void* data, size_t size);
+    StageHash& Add(const string& text) { Add((uint64_t)text.size()); return Add(text.data(), text.size()); }
+
+    template <typename T>
+    StageHash& Add(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be hashed by their bytes");
+        return Add(&value, sizeof(T));
+    }
+
+    // Contents of a whole file, false when it cannot be read
+    bool AddFile(const string& filePath);
+
+    uint64_t Get() const;
+
+private:
+    uint64_t state;
+    uint64_t length = 0;
+};
+
+struct StageCacheStatistics
+{
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t insertions = 0;
+    size_t evictions = 0;
+    size_t numberOfEntries = 0;
+    uint64_t numberOfBytes = 0;
+};
+
+// Content-addressed store for stage outputs, one file per entry named after the key in the stages subdirectory
+// of the cache directory. Other files found there are left alone.
+// When an insertion takes the total size over maximumBytes, the least recently used entries are removed.
+// Recency survives across runs as the modification time of the entry files, which a hit refreshes.
+// Pinned entries and files that cannot be removed yet stay in the cache, even over maximumBytes.
+// All members can be used from several threads.
+class StageCache
+{
+public:
+    using FileFunction = std::function<bool(const std::string&)>;
+
+    StageCache(const string& directory, uint64_t maximumBytes = 4ull << 30);
+
+    // Calls reader with the path of the entry. A missing entry or a failing reader is a miss.
+    // A pinned hit is never evicted until it is released, for readers that keep the file open or mapped.
+    bool Load(uint64_t key, const string& extension, const FileFunction& reader, bool pin = false);
+    void Release(uint64_t key, const string& extension);
+    // Calls writer with a temporary path and publishes the file as the entry when it succeeds
+    bool Store(uint64_t key, const string& extension, const FileFunction& writer);
+
+    StageCacheStatistics GetStatistics() const;
+    inline const string& GetDirectory() const { return directory; }
+    inline uint64_t GetMaximumBytes() const { return maximumBytes; }
+
+private:
+    struct Entry
+    {
+        string fileName;
+        uint64_t size;
+        std::list<string>::iterator recency;
+        size_t pins = 0;
+    };
+
+    string directory;
+    uint64_t maximumBytes;
+
+    mutable std::mutex mutex;
+    unordered_map<string, Entry> entries;
+    // Most recently used first
+    std::list<string> recency;
+    StageCacheStatistics statistics;
+
+    static string FileName(uint64_t key, const string& extension);
+    void Touch(Entry& entry);
+    void Evict();
+};
@@ -0,0 +1,64 @@
+#include <App/ThreadPool.h>
+
+ThreadPool::ThreadPool(size_t numberOfThreads)
+{
+    if (0 == numberOfThreads)
+    {
+        numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (size_t i = 0; i < numberOfThreads; i++)
+    {
+        workers.emplace_back(&ThreadPool::Work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskCondition.notify_all();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idleCondition.wait(lock, [&] { return tasks.empty() && 0 == numberOfRunningTasks; });
+}
+
+void ThreadPool::Work()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // Queued tasks are still run when stopping, so every future gets its value
+            taskCondition.wait(lock, [&] { return stopping || false == tasks.empty(); });
+            if (tasks.empty())
+                return;
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            numberOfRunningTasks++;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            numberOfRunningTasks--;
+            if (tasks.empty() && 0 == numberOfRunningTasks)
+            {
+                idleCondition.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Common.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+// Fixed set of worker threads running queued tasks in submission order.
+class ThreadPool
+{
+public:
+    // 0 threads means one per hardware thread
+    explicit ThreadPool(size_t numberOfThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto Enqueue(F&& f) -> std::future<decltype(f())>
+    {
+        using Result = decltype(f());
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+        auto future = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace_back([task]() { (*task)(); });
+        }
+        taskCondition.notify_one();
+        return future;
+    }
+
+    // Blocks until the queue is empty and no task is running
+    void Wait();
+
+    inline size_t GetNumberOfThreads() const { return workers.size(); }
+
+private:
+    vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskCondition;
+    std::condition_variable idleCondition;
+    size_t numberOfRunningTasks = 0;
+    bool stopping = false;
+
+    void Work();
+};
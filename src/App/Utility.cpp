@@ -1,8 +1,9 @@
 #include <App/Utility.h>
+#include <App/PLYFile.h>
 
 string Miliseconds(const chrono::steady_clock::time_point beginTime, const char* tag)
 {
-    auto now = chrono::high_resolution_clock::now();
+    auto now = chrono::steady_clock::now();
     auto timeSpan = chrono::duration_cast<chrono::nanoseconds>(now - beginTime).count();
     stringstream ss;
     ss << "[[[ ";
@@ -15,19 +16,30 @@ string Miliseconds(const chrono::steady_clock::time_point beginTime, const char*
 }
 
 vtkSmartPointer<vtkPolyData> ReadPLY(const std::string& filePath) {
+    auto polyData = ReadPLYFast(filePath);
+    if (nullptr != polyData)
+        return polyData;
+
     vtkSmartPointer<vtkPLYReader> reader = vtkSmartPointer<vtkPLYReader>::New();
     reader->SetFileName(filePath.c_str());
     reader->Update();
     return reader->GetOutput();
 }
 
-void WritePLY(vtkSmartPointer<vtkPolyData> data, const std::string& filePath) {
+bool WritePLY(vtkSmartPointer<vtkPolyData> data, const std::string& filePath) {
+    if (WritePLYBinary(data, filePath))
+        return true;
+    if (nullptr == data)
+        return false;
+
     vtkSmartPointer<vtkPLYWriter> writer = vtkSmartPointer<vtkPLYWriter>::New();
     writer->SetFileName(filePath.c_str());
+    writer->SetFileTypeToBinary();
     writer->SetInputData(data);
-    writer->Update();
+    return 1 == writer->Write();
 }
 
+#ifdef _WIN32
 BOOL CALLBACK MonitorEnumProc(HMONITOR hMonitor, HDC hdcMonitor, LPRECT lprcMonitor, LPARAM dwData) {
     std::vector<MonitorInfo>* monitors = reinterpret_cast<std::vector<MonitorInfo>*>(dwData);
     MONITORINFO monitorInfo;
@@ -77,3 +89,10 @@ void MaximizeVTKWindowOnMonitor(vtkSmartPointer<vtkRenderWindow> renderWindow, i
         ShowWindow(hwnd, SW_MAXIMIZE);
     }
 }
+#else
+void MaximizeConsoleWindowOnMonitor(int monitorIndex) {
+}
+
+void MaximizeVTKWindowOnMonitor(vtkSmartPointer<vtkRenderWindow> renderWindow, int monitorIndex) {
+}
+#endif
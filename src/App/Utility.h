@@ -3,17 +3,22 @@
 #include <Common.h>
 
 string Miliseconds(const chrono::steady_clock::time_point beginTime, const char* tag = nullptr);
-#define TS(name) auto time_##name = chrono::high_resolution_clock::now()();
+#define TS(name) auto time_##name = chrono::steady_clock::now();
 #define TE(name) std::cout << Miliseconds(time_##name, #name) << std::endl;
 
 vtkSmartPointer<vtkPolyData> ReadPLY(const std::string& filePath);
-void WritePLY(vtkSmartPointer<vtkPolyData> data, const std::string& filePath);
+// Fast binary writer when the data allows it, vtkPLYWriter otherwise. Returns false when the file was not written
+bool WritePLY(vtkSmartPointer<vtkPolyData> data, const std::string& filePath);
 
+#ifdef _WIN32
 struct MonitorInfo {
     HMONITOR hMonitor;
     MONITORINFO monitorInfo;
 };
 
 BOOL CALLBACK MonitorEnumProc(HMONITOR hMonitor, HDC hdcMonitor, LPRECT lprcMonitor, LPARAM dwData);
+#endif
+
+// No-ops on platforms without Win32 monitors
 void MaximizeConsoleWindowOnMonitor(int monitorIndex);
 void MaximizeVTKWindowOnMonitor(vtkSmartPointer<vtkRenderWindow> renderWindow, int monitorIndex);
\ No newline at end of file
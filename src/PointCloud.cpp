@@ -21,6 +21,10 @@
 #include <string>
 #include <sstream>
 
+#include <Algorithm/VDBUtility.h>
+#include <Algorithm/vtkGridMesher.h>
+#include <Algorithm/vtkQuantizingFilter.h>
+
 vtkSmartPointer<vtkPolyData> readPLY(const std::string& filePath) {
     vtkSmartPointer<vtkPLYReader> reader = vtkSmartPointer<vtkPLYReader>::New();
     reader->SetFileName(filePath.c_str());
@@ -50,63 +54,10 @@ std::vector<openvdb::Vec3s> polyDataToVector(vtkSmartPointer<vtkPolyData> polyDa
 }
 
 openvdb::FloatGrid::Ptr createOpenVDBVolume(const std::vector<openvdb::Vec3s>& points, float voxelSize = 0.1f) {
-    openvdb::FloatGrid::Ptr grid = openvdb::FloatGrid::create(0.0f);
-    grid->setTransform(openvdb::math::Transform::createLinearTransform(voxelSize));
-
-    openvdb::FloatGrid::Accessor accessor = grid->getAccessor();
-
-    for (const auto& point : points) {
-        openvdb::Coord xyz = grid->transform().worldToIndexNodeCentered(point);
-        accessor.setValue(xyz, 1.0f);
-    }
-
-    return grid;
+    // Vec3s is three packed floats
+    return VoxelizePoints(reinterpret_cast<const float*>(points.data()), points.size(), voxelSize);
 }
 
-vtkSmartPointer<vtkPolyData> openVDBToMesh(openvdb::FloatGrid::Ptr grid) {
-    std::vector<openvdb::Vec3s> points;
-    std::vector<openvdb::Vec3I> triangles;
-    std::vector<openvdb::Vec4I> quads;
-
-    // Convert VDB grid to mesh
-    double isovalue = 0.5;
-    double adaptivity = 0.0;
-    openvdb::tools::volumeToMesh(*grid, points, triangles, quads, isovalue, adaptivity);
-
-    // Create VTK points
-    vtkSmartPointer<vtkPoints> vtkPts = vtkSmartPointer<vtkPoints>::New();
-    for (const auto& point : points) {
-        vtkPts->InsertNextPoint(point.x(), point.y(), point.z());
-    }
-
-    // Create VTK cells
-    vtkSmartPointer<vtkCellArray> vtkPolys = vtkSmartPointer<vtkCellArray>::New();
-    for (const auto& triangle : triangles) {
-        vtkPolys->InsertNextCell(3);
-        vtkPolys->InsertCellPoint(triangle[0]);
-        vtkPolys->InsertCellPoint(triangle[1]);
-        vtkPolys->InsertCellPoint(triangle[2]);
-    }
-    for (const auto& quad : quads) {
-        vtkPolys->InsertNextCell(4);
-        vtkPolys->InsertCellPoint(quad[0]);
-        vtkPolys->InsertCellPoint(quad[1]);
-        vtkPolys->InsertCellPoint(quad[2]);
-        vtkPolys->InsertCellPoint(quad[3]);
-    }
-
-    // Create VTK polydata
-    vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
-    polyData->SetPoints(vtkPts);
-    polyData->SetPolys(vtkPolys);
-
-    return polyData;
-}
-
-#define SUB(a, b) ((a) - (b))
-#define SQUARE(a) ((a) * (a))
-#define DISTANCE(p0, p1) sqrtf(SQUARE(SUB(p1[0], p0[0])) + SQUARE(SUB(p1[1], p0[1])) + SQUARE(SUB(p1[2], p0[2])))
-
 int main() {
     openvdb::initialize();
 
@@ -183,36 +134,14 @@ int main() {
         }
     }
 
-    vtkNew<vtkCellArray> triangles;
-    for (int y = 0; y < patch_height; y++)
-    {
-        for (int x = 0; x < patch_width; x++)
-        {
-            vtkIdType pi00 = y * (patch_width + 1) + x;
-            vtkIdType pi01 = y * (patch_width + 1) + (x + 1);
-            vtkIdType pi10 = (y + 1) * (patch_width + 1) + x;
-            vtkIdType pi11 = (y + 1) * (patch_width + 1) + (x + 1);
-
-            auto p00 = planePoints->GetPoint(pi00);
-            auto p01 = planePoints->GetPoint(pi01);
-            auto p10 = planePoints->GetPoint(pi10);
-            auto p11 = planePoints->GetPoint(pi11);
+    // Cells no point fell into stay at FLT_MAX, which the mesher treats as empty
+    vtkQuantizingFilter::SetGridDimensions(polyData, patch_width + 1, patch_height + 1);
 
-            if (0.2f < DISTANCE(p00, p01))
-            {
-
-            }
-
-            // First triangle (lower-left)
-            vtkIdType triangle0[3] = { pi00, pi01, pi11 };
-            triangles->InsertNextCell(3, triangle0);
-
-            // Second triangle (upper-right)
-            vtkIdType triangle1[3] = { pi00, pi11, pi10 };
-            triangles->InsertNextCell(3, triangle1);
-        }
-    }
-    polyData->SetPolys(triangles);
+    vtkSmartPointer<vtkGridMesher> gridMesher = vtkSmartPointer<vtkGridMesher>::New();
+    gridMesher->SetInputData(polyData);
+    gridMesher->SetMaxEdgeLength(0.2f);
+    gridMesher->Update();
+    polyData->SetPolys(gridMesher->GetOutput()->GetPolys());
 
     writePLY(polyData, "C:\\Resources\\Debug\\HD\\patch_mesh_0.ply");
 
@@ -13,6 +13,8 @@
 #include <openvdb/tools/LevelSetSphere.h>
 #include <openvdb/tools/VolumeToMesh.h>
 
+#include <Algorithm/VDBUtility.h>
+
 int main()
 {
     // Initialize OpenVDB
@@ -26,51 +28,8 @@ int main()
     openvdb::FloatGrid::Ptr sphereGrid = openvdb::tools::createLevelSetSphere<openvdb::FloatGrid>(
         radius, center, voxelSize, halfWidth);
 
-    // Convert the VDB level set into a mesh
-    openvdb::tools::VolumeToMesh mesher;
-    mesher(*sphereGrid);
-
-    // Create VTK objects to store the mesh data
-    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
-    vtkSmartPointer<vtkCellArray> triangles = vtkSmartPointer<vtkCellArray>::New();
-
-    // Extract points and triangles from the OpenVDB mesh
-    for (size_t i = 0; i < mesher.pointListSize(); ++i) {
-        const openvdb::Vec3s& p = mesher.pointList()[i];
-        points->InsertNextPoint(p.x(), p.y(), p.z());
-    }
-
-    for (size_t i = 0; i < mesher.polygonPoolListSize(); ++i) {
-        const openvdb::tools::PolygonPool& pool = mesher.polygonPoolList()[i];
-        for (size_t j = 0; j < pool.numQuads(); ++j) {
-            openvdb::Vec4I quad = pool.quad(j);
-            vtkSmartPointer<vtkTriangle> triangle1 = vtkSmartPointer<vtkTriangle>::New();
-            triangle1->GetPointIds()->SetId(0, quad[0]);
-            triangle1->GetPointIds()->SetId(1, quad[1]);
-            triangle1->GetPointIds()->SetId(2, quad[2]);
-            triangles->InsertNextCell(triangle1);
-
-            vtkSmartPointer<vtkTriangle> triangle2 = vtkSmartPointer<vtkTriangle>::New();
-            triangle2->GetPointIds()->SetId(0, quad[2]);
-            triangle2->GetPointIds()->SetId(1, quad[3]);
-            triangle2->GetPointIds()->SetId(2, quad[0]);
-            triangles->InsertNextCell(triangle2);
-        }
-
-        for (size_t j = 0; j < pool.numTriangles(); ++j) {
-            openvdb::Vec3I tri = pool.triangle(j);
-            vtkSmartPointer<vtkTriangle> triangle = vtkSmartPointer<vtkTriangle>::New();
-            triangle->GetPointIds()->SetId(0, tri[0]);
-            triangle->GetPointIds()->SetId(1, tri[1]);
-            triangle->GetPointIds()->SetId(2, tri[2]);
-            triangles->InsertNextCell(triangle);
-        }
-    }
-
-    // Create a polydata object
-    vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
-    polyData->SetPoints(points);
-    polyData->SetPolys(triangles);
+    // Convert the VDB level set into a triangle mesh
+    vtkSmartPointer<vtkPolyData> polyData = VDBToMesh(sphereGrid, 0.0, 0.0, true);
 
     // Create a mapper
     vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
@@ -6,8 +6,7 @@
 #include <vtkCellArray.h>
 #include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
-#include <vtkSurfaceReconstructionFilter.h>
-#include <vtkContourFilter.h>
+#include <vtkPointData.h>
 #include <vtkActor.h>
 #include <vtkRenderer.h>
 #include <vtkRenderWindow.h>
@@ -21,6 +20,9 @@
 #include <string>
 #include <sstream>
 
+#include <Algorithm/VDBUtility.h>
+#include <Algorithm/vtkNormalEstimationFilter.h>
+
 vtkSmartPointer<vtkPolyData> readPLY(const std::string& filePath) {
 	vtkSmartPointer<vtkPLYReader> reader = vtkSmartPointer<vtkPLYReader>::New();
 	reader->SetFileName(filePath.c_str());
@@ -43,57 +45,8 @@ std::vector<openvdb::Vec3s> polyDataToVector(vtkSmartPointer<vtkPolyData> polyDa
 }
 
 openvdb::FloatGrid::Ptr createOpenVDBVolume(const std::vector<openvdb::Vec3s>& points, float voxelSize = 0.1f) {
-	openvdb::FloatGrid::Ptr grid = openvdb::FloatGrid::create(0.0f);
-	grid->setTransform(openvdb::math::Transform::createLinearTransform(voxelSize));
-
-	openvdb::FloatGrid::Accessor accessor = grid->getAccessor();
-
-	for (const auto& point : points) {
-		openvdb::Coord xyz = grid->transform().worldToIndexNodeCentered(point);
-		accessor.setValue(xyz, 1.0f);
-	}
-
-	return grid;
-}
-
-vtkSmartPointer<vtkPolyData> openVDBToMesh(openvdb::FloatGrid::Ptr grid) {
-	std::vector<openvdb::Vec3s> points;
-	std::vector<openvdb::Vec3I> triangles;
-	std::vector<openvdb::Vec4I> quads;
-
-	// Convert VDB grid to mesh
-	double isovalue = 0.5;
-	double adaptivity = 0.0;
-	openvdb::tools::volumeToMesh(*grid, points, triangles, quads, isovalue, adaptivity);
-
-	// Create VTK points
-	vtkSmartPointer<vtkPoints> vtkPts = vtkSmartPointer<vtkPoints>::New();
-	for (const auto& point : points) {
-		vtkPts->InsertNextPoint(point.x(), point.y(), point.z());
-	}
-
-	// Create VTK cells
-	vtkSmartPointer<vtkCellArray> vtkPolys = vtkSmartPointer<vtkCellArray>::New();
-	for (const auto& triangle : triangles) {
-		vtkPolys->InsertNextCell(3);
-		vtkPolys->InsertCellPoint(triangle[0]);
-		vtkPolys->InsertCellPoint(triangle[1]);
-		vtkPolys->InsertCellPoint(triangle[2]);
-	}
-	for (const auto& quad : quads) {
-		vtkPolys->InsertNextCell(4);
-		vtkPolys->InsertCellPoint(quad[0]);
-		vtkPolys->InsertCellPoint(quad[1]);
-		vtkPolys->InsertCellPoint(quad[2]);
-		vtkPolys->InsertCellPoint(quad[3]);
-	}
-
-	// Create VTK polydata
-	vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
-	polyData->SetPoints(vtkPts);
-	polyData->SetPolys(vtkPolys);
-
-	return polyData;
+	// Vec3s is three packed floats
+	return VoxelizePoints(reinterpret_cast<const float*>(points.data()), points.size(), voxelSize);
 }
 
 void visualizeVTK(vtkSmartPointer<vtkPolyData> polyData) {
@@ -142,6 +95,67 @@ void visualizeVTK(vtkAlgorithmOutput* input) {
 	interactor->Start();
 }
 
+struct LODSwitch {
+	const std::vector<MeshLOD>* lods;
+	vtkPolyDataMapper* mapper;
+	vtkRenderer* renderer;
+	size_t current;
+};
+
+// Before every frame, shows the coarsest LOD whose error stays under a pixel at the camera's distance from the bounds
+void switchLOD(vtkObject* caller, unsigned long, void* clientData, void*) {
+	auto lodSwitch = static_cast<LODSwitch*>(clientData);
+	auto renderWindow = static_cast<vtkRenderWindow*>(caller);
+	auto camera = lodSwitch->renderer->GetActiveCamera();
+
+	double bounds[6];
+	lodSwitch->lods->front().mesh->GetBounds(bounds);
+	auto position = camera->GetPosition();
+	double nearest[3];
+	for (int axis = 0; axis < 3; axis++) {
+		nearest[axis] = std::clamp(position[axis], bounds[axis * 2], bounds[axis * 2 + 1]);
+	}
+	auto distance = std::sqrt(vtkMath::Distance2BetweenPoints(position, nearest));
+
+	auto index = SelectLOD(*lodSwitch->lods, distance, camera->GetViewAngle(), renderWindow->GetSize()[1]);
+	if (index != lodSwitch->current) {
+		lodSwitch->current = index;
+		lodSwitch->mapper->SetInputData(lodSwitch->lods->at(index).mesh);
+	}
+}
+
+void visualizeLODs(const std::vector<MeshLOD>& lods) {
+	if (lods.empty()) {
+		return;
+	}
+
+	vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+	mapper->SetInputData(lods.front().mesh);
+
+	vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+	actor->SetMapper(mapper);
+	actor->GetProperty()->SetColor(1.0, 1.0, 1.0);
+
+	vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+	vtkSmartPointer<vtkRenderWindow> renderWindow = vtkSmartPointer<vtkRenderWindow>::New();
+	renderWindow->AddRenderer(renderer);
+	vtkSmartPointer<vtkRenderWindowInteractor> interactor = vtkSmartPointer<vtkRenderWindowInteractor>::New();
+	vtkNew<vtkInteractorStyleTrackballCamera> trackballStyle;
+	interactor->SetInteractorStyle(trackballStyle);
+	interactor->SetRenderWindow(renderWindow);
+
+	renderer->AddActor(actor);
+	renderer->SetBackground(0.3, 0.5, 0.7);
+
+	LODSwitch lodSwitch{ &lods, mapper, renderer, 0 };
+	vtkNew<vtkCallbackCommand> lodCallback;
+	lodCallback->SetCallback(switchLOD);
+	lodCallback->SetClientData(&lodSwitch);
+	renderWindow->AddObserver(vtkCommand::StartEvent, lodCallback);
+
+	interactor->Start();
+}
+
 int main() {
 	openvdb::initialize();
 
@@ -225,18 +239,19 @@ int main() {
 		vtkNew<vtkPolyData> polyData;
 		polyData->SetPoints(points);
 
-		vtkSmartPointer<vtkSurfaceReconstructionFilter> surfFilter =
-			vtkSmartPointer<vtkSurfaceReconstructionFilter>::New();
-		surfFilter->SetInputData(polyData);
-		surfFilter->Update();
+		// Normals turned toward the scanner at the origin give the distance field its sign
+		vtkSmartPointer<vtkNormalEstimationFilter> normalEstimation =
+			vtkSmartPointer<vtkNormalEstimationFilter>::New();
+		normalEstimation->SetInputData(polyData);
+		normalEstimation->SetNumberOfNeighbors(16);
+		normalEstimation->SetViewPoint(0.0, 0.0, 0.0);
+		normalEstimation->Update();
 
-		vtkSmartPointer<vtkContourFilter> contourFilter =
-			vtkSmartPointer<vtkContourFilter>::New();
-		contourFilter->SetInputConnection(surfFilter->GetOutputPort());
-		contourFilter->SetValue(0, 0.0);
-		contourFilter->Update();
+		// Sparse narrow-band distance field instead of vtkSurfaceReconstructionFilter's dense volume
+		auto grid = CreateVDBVolume(normalEstimation->GetOutput(), 0.1f, 3.0f);
+		auto lods = VDBToMeshLODs(grid, 0.0);
 
-		visualizeVTK(contourFilter->GetOutputPort());
+		visualizeLODs(lods);
 	}
 
 	return 0;
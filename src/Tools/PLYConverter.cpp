@@ -0,0 +1,61 @@
+#include <Common.h>
+
+#include <App/PLYFile.h>
+#include <App/Utility.h>
+
+#include <filesystem>
+#include <atomic>
+
+// Converts every .ply file of a directory, for example res/PLY/Patches, to binary little-endian.
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cout << "Usage: PLYConverter <input directory> <output directory>" << std::endl;
+        return 1;
+    }
+
+    std::filesystem::path inputDirectory(argv[1]);
+    std::filesystem::path outputDirectory(argv[2]);
+    std::filesystem::create_directories(outputDirectory);
+
+    vector<std::filesystem::path> files;
+    for (auto& entry : std::filesystem::directory_iterator(inputDirectory))
+    {
+        if (entry.is_regular_file() && ".ply" == entry.path().extension())
+        {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    auto beginTime = chrono::steady_clock::now();
+
+    std::atomic<uintmax_t> inputBytes(0);
+    std::atomic<uintmax_t> outputBytes(0);
+    std::atomic<int> failures(0);
+
+    vtkSMPTools::For(0, (vtkIdType)files.size(), [&](vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType i = begin; i < end; i++)
+            {
+                auto outputPath = outputDirectory / files[i].filename();
+
+                auto polyData = ReadPLY(files[i].string());
+                if (nullptr == polyData || false == WritePLY(polyData, outputPath.string()))
+                {
+                    std::cerr << "Failed to convert " << files[i] << std::endl;
+                    failures++;
+                    continue;
+                }
+
+                inputBytes += std::filesystem::file_size(files[i]);
+                outputBytes += std::filesystem::file_size(outputPath);
+            }
+        });
+
+    std::cout << files.size() - failures << " files, " << inputBytes << " -> " << outputBytes << " bytes" << std::endl;
+    std::cout << Miliseconds(beginTime, "PLYConverter") << std::endl;
+
+    return 0 == failures ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+#include <Common.h>
+
+#include <openvdb/openvdb.h>
+
+#include <App/BatchPipeline.h>
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::cout << "Usage: SVOBatch <input directory> <output directory> [options]" << std::endl;
+        std::cout << "  --stages <list>      comma separated, default load,quantize,filter,voxelize,mesh,write" << std::endl;
+        std::cout << "  --threads <n>        worker threads, default one per hardware thread" << std::endl;
+        std::cout << "  --image <w> <h>      quantization grid size, default 256 480" << std::endl;
+        std::cout << "  --interval <w> <h>   quantization cell size, default 0.1 0.1" << std::endl;
+        std::cout << "  --kernel <n>         depth median kernel size, 3, 5 or 7" << std::endl;
+        std::cout << "  --normals <k>        neighbours per point, adds the normals stage after the point stages" << std::endl;
+        std::cout << "                       and writes nx ny nz with the points or the mesh" << std::endl;
+        std::cout << "  --voxel-size <s>     default 0.1" << std::endl;
+        std::cout << "  --narrow-band <w>    level set half width in voxels, default 0 for occupancy" << std::endl;
+        std::cout << "  --radius <r>         level set particle radius" << std::endl;
+        std::cout << "  --volume <steps>     grid steps for the volume stage, name[:width[:iterations]] of" << std::endl;
+        std::cout << "                       dilate, erode, gaussian, mean, median, renormalize" << std::endl;
+        std::cout << "  --isovalue <v>       default 0.5" << std::endl;
+        std::cout << "  --adaptivity <a>     default 0.0" << std::endl;
+        std::cout << "  --max-edge <l>       grid triangulation edge limit without voxelize, default 0.2" << std::endl;
+        std::cout << "  --decimate <r>       fraction of the mesh triangles to remove, adds the decimate stage" << std::endl;
+        std::cout << "  --stitch <file>      stitch the patch meshes into one .ply" << std::endl;
+        std::cout << "  --stitch-overlap <d> overlap removal distance, default 0.1" << std::endl;
+        std::cout << "  --stitch-snap <d>    seam snapping distance, default 0.05" << std::endl;
+        std::cout << "  --cache <directory>  memoize stage outputs there" << std::endl;
+        std::cout << "  --cache-size <MB>    cache size cap, default 4096" << std::endl;
+        std::cout << "  --grid-compression <c>  none, zip or blosc for cached grids, default blosc" << std::endl;
+    }
+}
+
+// Runs the processing stages over a directory of patches without opening a window.
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    BatchOptions options;
+    options.inputDirectory = argv[1];
+    options.outputDirectory = argv[2];
+
+    bool normals = false;
+    bool decimate = false;
+    // Malformed numbers print the usage like unknown options do
+    try
+    {
+        for (int i = 3; i < argc; i++)
+        {
+            string option = argv[i];
+            auto remaining = argc - i - 1;
+            if ("--stages" == option && 1 <= remaining)
+            {
+                if (false == ParseBatchStages(argv[++i], options.stages))
+                {
+                    std::cerr << "Unknown stage in " << argv[i] << std::endl;
+                    return 1;
+                }
+            }
+            else if ("--threads" == option && 1 <= remaining) options.numberOfThreads = (size_t)std::stoul(argv[++i]);
+            else if ("--image" == option && 2 <= remaining)
+            {
+                options.imageWidth = (unsigned int)std::stoul(argv[++i]);
+                options.imageHeight = (unsigned int)std::stoul(argv[++i]);
+            }
+            else if ("--interval" == option && 2 <= remaining)
+            {
+                options.wInterval = std::stof(argv[++i]);
+                options.hInterval = std::stof(argv[++i]);
+            }
+            else if ("--kernel" == option && 1 <= remaining) options.kernelSize = std::stoi(argv[++i]);
+            else if ("--normals" == option && 1 <= remaining)
+            {
+                options.normalNeighbors = std::stoi(argv[++i]);
+                normals = true;
+            }
+            else if ("--voxel-size" == option && 1 <= remaining) options.voxelSize = std::stof(argv[++i]);
+            else if ("--narrow-band" == option && 1 <= remaining) options.narrowBandWidth = std::stof(argv[++i]);
+            else if ("--radius" == option && 1 <= remaining) options.particleRadius = std::stof(argv[++i]);
+            else if ("--volume" == option && 1 <= remaining)
+            {
+                if (false == ParseVolumeSteps(argv[++i], options.volumeSteps))
+                {
+                    std::cerr << "Unknown volume step in " << argv[i] << std::endl;
+                    return 1;
+                }
+            }
+            else if ("--isovalue" == option && 1 <= remaining) options.isovalue = std::stod(argv[++i]);
+            else if ("--adaptivity" == option && 1 <= remaining) options.adaptivity = std::stod(argv[++i]);
+            else if ("--max-edge" == option && 1 <= remaining) options.maxEdgeLength = std::stof(argv[++i]);
+            else if ("--decimate" == option && 1 <= remaining)
+            {
+                options.decimateReduction = std::stod(argv[++i]);
+                decimate = true;
+            }
+            else if ("--stitch" == option && 1 <= remaining) options.stitchedFilePath = argv[++i];
+            else if ("--stitch-overlap" == option && 1 <= remaining) options.stitchOverlapDistance = std::stod(argv[++i]);
+            else if ("--stitch-snap" == option && 1 <= remaining) options.stitchSnapDistance = std::stod(argv[++i]);
+            else if ("--cache" == option && 1 <= remaining) options.cacheDirectory = argv[++i];
+            else if ("--cache-size" == option && 1 <= remaining) options.cacheBytes = (uint64_t)std::stoull(argv[++i]) << 20;
+            else if ("--grid-compression" == option && 1 <= remaining)
+            {
+                if (false == ParseVDBCompression(argv[++i], options.gridCompression))
+                {
+                    std::cerr << "Unknown grid compression " << argv[i] << std::endl;
+                    return 1;
+                }
+            }
+            else
+            {
+                PrintUsage();
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Invalid argument: " << e.what() << std::endl;
+        PrintUsage();
+        return 1;
+    }
+
+    // Normals are estimated right after the last of load, quantize and filter
+    auto& stages = options.stages;
+    auto lastPointStage = std::find_if(stages.rbegin(), stages.rend(), [](BatchStage stage)
+        {
+            return BatchStage::Load == stage || BatchStage::Quantize == stage || BatchStage::Filter == stage;
+        });
+    if (normals && stages.rend() != lastPointStage
+        && stages.end() == std::find(stages.begin(), stages.end(), BatchStage::Normals))
+    {
+        stages.insert(lastPointStage.base(), BatchStage::Normals);
+    }
+
+    // Volume steps run right after voxelize unless the stage list places the volume stage itself
+    auto voxelize = std::find(stages.begin(), stages.end(), BatchStage::Voxelize);
+    if (false == options.volumeSteps.empty() && stages.end() != voxelize
+        && stages.end() == std::find(stages.begin(), stages.end(), BatchStage::Volume))
+    {
+        stages.insert(voxelize + 1, BatchStage::Volume);
+    }
+    // Likewise decimation right after mesh
+    auto mesh = std::find(stages.begin(), stages.end(), BatchStage::Mesh);
+    if (decimate && stages.end() != mesh && stages.end() == std::find(stages.begin(), stages.end(), BatchStage::Decimate))
+    {
+        stages.insert(mesh + 1, BatchStage::Decimate);
+    }
+
+    openvdb::initialize();
+
+    BatchPipeline pipeline(options);
+    auto succeeded = pipeline.Run();
+    pipeline.PrintReport(std::cout);
+
+    return succeeded ? 0 : 1;
+}
@@ -7,6 +7,7 @@
 #include <Eigen/IterativeLinearSolvers>
 
 #include <App/CustomTrackballStyle.h>
+#include <App/PatchPrefetcher.h>
 #include <App/Utility.h>
 
 #include <Algorithm/vtkMedianFilter.h>
@@ -418,6 +419,9 @@ float GetDistance(const float* points, unsigned int point_index, const float* qu
 int main() {
     openvdb::initialize();
 
+    // The patch is read on a background thread while the window is being set up
+    PatchPrefetcher prefetcher({ "C:\\Resources\\Debug\\patches\\0.ply" }, 1, 1);
+
     MaximizeConsoleWindowOnMonitor(1);
 
     vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
@@ -439,7 +443,28 @@ int main() {
 
     MaximizeVTKWindowOnMonitor(renderWindow, 2);
 
-    auto inputPoints = ReadPLY("C:\\Resources\\Debug\\patches\\0.ply");
+    Patch patch;
+    if (false == prefetcher.Next(patch) || nullptr == patch.data)
+    {
+        std::cerr << "Error: no patch could be loaded";
+        if (nullptr != patch.error)
+        {
+            try
+            {
+                std::rethrow_exception(patch.error);
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << ", " << e.what();
+            }
+            catch (...)
+            {
+            }
+        }
+        std::cerr << std::endl;
+        return 1;
+    }
+    auto inputPoints = patch.data;
 
     vtkSmartPointer<vtkQuantizingFilter> quantizingFilter = vtkSmartPointer<vtkQuantizingFilter>::New();
 	quantizingFilter->SetInputData(inputPoints);
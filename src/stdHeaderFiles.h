@@ -5,6 +5,13 @@
 #include <string>
 #include <sstream>
 #include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <cstdint>
+#ifdef _WIN32
 #include <windows.h>
 #include <shellapi.h>
+#endif
 using namespace std;
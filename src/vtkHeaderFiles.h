@@ -4,6 +4,8 @@
 #include <vtkNew.h>
 #include <vtkFloatArray.h>
 #include <vtkDoubleArray.h>
+#include <vtkIntArray.h>
+#include <vtkIdTypeArray.h>
 #include <vtkUnsignedCharArray.h>
 #include <vtkTransform.h>
 
@@ -24,6 +26,9 @@
 #include <vtkProperty.h>
 #include <vtkProperty2D.h>
 
+#include <vtkMath.h>
+#include <vtkIdList.h>
+
 #include <vtkCamera.h>
 #include <vtkPointData.h>
 #include <vtkLine.h>
@@ -31,7 +36,9 @@
 #include <vtkQuad.h>
 #include <vtkCellData.h>
 #include <vtkUnstructuredGrid.h>
+#include <vtkCellArray.h>
 #include <vtkPolyData.h>
+#include <vtkImageData.h>
 #include <vtkAppendPolyData.h>
 
 #include <vtkCylinderSource.h>
@@ -70,6 +77,10 @@
 #include <vtkOrientationMarkerWidget.h>
 
 #include <vtkPolyDataAlgorithm.h>
+#include <vtkSMPTools.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkArrayListTemplate.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
 
@@ -81,9 +92,12 @@
 #include <vtkSmoothPolyDataFilter.h>
 #include <vtkWindowedSincPolyDataFilter.h>
 #include <vtkKdTreePointLocator.h>
+#include <vtkStaticPointLocator.h>
 #include <vtkLinearExtrusionFilter.h>
 #include <vtkContourFilter.h>
 #include <vtkCellLocator.h>
+#include <vtkStaticCellLocator.h>
+#include <vtkGenericCell.h>
 #include <vtkSignedDistance.h>
 
 #include <vtkExtractCells.h>